@@ -1,8 +1,46 @@
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define HAS_IO_URING
+#endif
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 /*
@@ -14,6 +52,15 @@ of characteristic 2. Implemented are also:
 
 // Set below variable RUN_TESTS to true to run tests
 const bool RUN_TESTS = false;
+// Set below variable RUN_BENCHMARKS to true to run benchmarks
+const bool RUN_BENCHMARKS = false;
+// Set below variable to a degree like 19937 to search for irreducible
+// trinomials of that degree instead of running the interactive application
+const int TRINOMIAL_SEARCH_DEGREE = 0;
+// Number of threads used by parallel operations, 0 for one per hardware
+// thread. With PIN_THREADS each worker thread stays on one CPU.
+const int THREADS = 0;
+const bool PIN_THREADS = false;
 const int SIZE = 64;
 using Polynomial = bitset<SIZE>;
 
@@ -62,6 +109,29 @@ Polynomial operator*(const Polynomial& a, const Polynomial& b) {
     return total;
 }
 
+// Branch-free versions of operator* and operator%: the iteration counts only
+// depend on the degree of the modulus and every conditional XOR is done with
+// a mask, so they neither mispredict on random data nor leak it via timing.
+Polynomial mulBranchFree(const Polynomial& a, const Polynomial& b) {
+    uint64_t x = a.to_ullong();
+    uint64_t y = b.to_ullong();
+    uint64_t total = 0;
+    for (int i = 0; i < SIZE; i++) {
+        total ^= (y << i) & (0 - ((x >> i) & 1));
+    }
+    return Polynomial(total);
+}
+
+Polynomial remBranchFree(const Polynomial& a, const Polynomial& b) {
+    uint64_t rem = a.to_ullong();
+    uint64_t divisor = b.to_ullong();
+    int bDeg = degree(b);
+    for (int i = SIZE - 1; i >= bDeg; i--) {
+        rem ^= (divisor << (i - bDeg)) & (0 - ((rem >> i) & 1));
+    }
+    return Polynomial(rem);
+}
+
 // The polynomial p is assumed to be primitive
 vector<Polynomial> findFieldElements(const Polynomial& p) {
     Polynomial first(0b1);
@@ -101,141 +171,7495 @@ bool isPrimitive(const Polynomial& p) {
     return order == groupOrder;
 }
 
-void prettyPrint(const Polynomial& a, int deg = -1) {
-    if (deg == -1) {
-        deg = degree(a);
+// Parallel operations share one work-stealing pool. Every worker owns a
+// deque of tasks: it pushes and pops its own tasks at the back and, when the
+// deque is empty, steals from the front of the others. A thread waiting for
+// its tasks runs queued tasks in the meantime, so a parallel operation called
+// from inside another one reuses the same workers instead of adding threads,
+// and sleeps when there are none. An exception thrown by a task is kept in
+// its group and rethrown by wait once all tasks of the group are done.
+struct TaskGroup {
+    atomic<size_t> pending{0};
+    mutex lock;
+    exception_ptr error;
+
+    // Keeps the first exception.
+    void fail(exception_ptr e) {
+        lock_guard<mutex> guard(lock);
+        if (!error) {
+            error = e;
+        }
     }
-    for (int i = 0; i <= deg; i++) {
-        cout << a[i];
+};
+
+struct Task {
+    function<void()> run;
+    TaskGroup* group;
+};
+
+struct TaskQueue {
+    mutex lock;
+    deque<Task> tasks;
+};
+
+struct ThreadPool;
+
+// The pool the current thread works for and the index of its queue. Threads
+// outside the pool share queue 0.
+thread_local ThreadPool* currentPool = nullptr;
+thread_local size_t currentQueue = 0;
+
+struct ThreadPool {
+    vector<unique_ptr<TaskQueue>> queues;
+    vector<thread> workers;
+    atomic<size_t> queued{0};
+    atomic<bool> stopping{false};
+    mutex sleepLock;
+    condition_variable wake;
+
+    // threads counts the calling thread, which works while it waits, so
+    // threads - 1 workers are started; 0 means one per hardware thread. With
+    // pin, worker i (from 1) is bound to CPU i modulo the hardware threads,
+    // so CPU 0 is left to the caller unless threads exceeds them.
+    explicit ThreadPool(int threads = 0, bool pin = false) {
+        int hardware = max(1, (int)thread::hardware_concurrency());
+        if (threads <= 0) {
+            threads = hardware;
+        }
+        for (int i = 0; i < threads; i++) {
+            queues.push_back(make_unique<TaskQueue>());
+        }
+        for (int i = 1; i < threads; i++) {
+            workers.emplace_back([this, i] { work(i); });
+#ifdef __linux__
+            if (pin) {
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET(i % hardware, &cpus);
+                pthread_setaffinity_np(workers.back().native_handle(),
+                                       sizeof(cpus), &cpus);
+            }
+#endif
+        }
     }
-    cout << '\n';
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    int size() const { return queues.size(); }
+
+    void submit(TaskGroup& group, function<void()> task) {
+        TaskQueue& queue = *queues[currentPool == this ? currentQueue : 0];
+        group.pending++;
+        // queued changes with the queue under its lock, so a thief cannot
+        // take the task and decrement the count before it was incremented.
+        {
+            lock_guard<mutex> guard(queue.lock);
+            queue.tasks.push_back({move(task), &group});
+            queued++;
+        }
+        // Taking the lock orders the increment before a sleeping worker's
+        // check, so the notification cannot be lost.
+        { lock_guard<mutex> guard(sleepLock); }
+        wake.notify_one();
+    }
+
+    // Runs one task, the newest of the own queue or else the oldest of
+    // another. Returns false if every queue was empty.
+    bool runOne() {
+        size_t self = currentPool == this ? currentQueue : 0;
+        Task task;
+        bool found = false;
+        for (size_t i = 0; i < queues.size() && !found; i++) {
+            TaskQueue& queue = *queues[(self + i) % queues.size()];
+            lock_guard<mutex> guard(queue.lock);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                task = move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            queued--;
+            found = true;
+        }
+        if (!found) {
+            return false;
+        }
+        run(*task.group, task.run);
+        // The group may be gone once pending is 0, so only the pool is
+        // touched afterwards, waking the thread that waits for it.
+        if (--task.group->pending == 0) {
+            { lock_guard<mutex> guard(sleepLock); }
+            wake.notify_all();
+        }
+        return true;
+    }
+
+    // Runs f for group, keeping what it throws in the group.
+    template <class F>
+    void run(TaskGroup& group, const F& f) {
+        try {
+            f();
+        } catch (...) {
+            group.fail(current_exception());
+        }
+    }
+
+    // Returns when the tasks of group are done, running queued tasks of any
+    // group meanwhile, and rethrows the first exception among them.
+    void wait(TaskGroup& group) {
+        while (group.pending != 0) {
+            if (runOne()) {
+                continue;
+            }
+            unique_lock<mutex> guard(sleepLock);
+            wake.wait(guard,
+                      [&] { return queued != 0 || group.pending == 0; });
+        }
+        if (group.error) {
+            exception_ptr error = group.error;
+            group.error = nullptr;
+            rethrow_exception(error);
+        }
+    }
+
+    void work(size_t self) {
+        currentPool = this;
+        currentQueue = self;
+        while (true) {
+            if (runOne()) {
+                continue;
+            }
+            unique_lock<mutex> guard(sleepLock);
+            wake.wait(guard, [this] { return stopping || queued != 0; });
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    // Calls body(from, to) on disjoint ranges of at least grain indices that
+    // cover [begin, end), and returns when all calls are done. There are a
+    // few ranges per thread so that uneven ranges balance out by stealing.
+    void parallelFor(size_t begin, size_t end,
+                     const function<void(size_t, size_t)>& body,
+                     size_t grain = 1) {
+        if (begin >= end) {
+            return;
+        }
+        size_t chunks = min((end - begin + grain - 1) / grain,
+                            (size_t)(4 * size()));
+        if (chunks <= 1) {
+            body(begin, end);
+            return;
+        }
+
+        TaskGroup group;
+        size_t step = (end - begin + chunks - 1) / chunks;
+        for (size_t from = begin + step; from < end; from += step) {
+            size_t to = min(end, from + step);
+            submit(group, [&body, from, to] { body(from, to); });
+        }
+        run(group, [&] { body(begin, begin + step); });
+        wait(group);
+    }
+
+    // Runs the tasks in parallel, the first one on the calling thread, and
+    // returns when all are done.
+    void invoke(initializer_list<function<void()>> tasks) {
+        TaskGroup group;
+        for (auto task = tasks.begin() + 1; task != tasks.end(); task++) {
+            submit(group, *task);
+        }
+        run(group, *tasks.begin());
+        wait(group);
+    }
+};
+
+// The pool used by all parallel operations.
+ThreadPool& threadPool() {
+    static ThreadPool pool(THREADS, PIN_THREADS);
+    return pool;
 }
 
-void prettyPrint(const vector<Polynomial>& polynomials) {
-    if (polynomials.empty()) {
-        return;
+uint64_t reverseBits(uint64_t a) {
+    a = ((a >> 1) & 0x5555555555555555ULL) | ((a & 0x5555555555555555ULL) << 1);
+    a = ((a >> 2) & 0x3333333333333333ULL) | ((a & 0x3333333333333333ULL) << 2);
+    a = ((a >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((a & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    a = ((a >> 8) & 0x00FF00FF00FF00FFULL) | ((a & 0x00FF00FF00FF00FFULL) << 8);
+    a = ((a >> 16) & 0x0000FFFF0000FFFFULL) |
+        ((a & 0x0000FFFF0000FFFFULL) << 16);
+    return (a >> 32) | (a << 32);
+}
+
+// x^deg * p(1/x). It is primitive exactly when p is.
+Polynomial reciprocal(const Polynomial& p) {
+    int deg = degree(p);
+    return Polynomial(reverseBits(p.to_ullong()) >> (SIZE - 1 - deg));
+}
+
+// Lyndon words of length n over {0, 1} (Duval's algorithm, constant amortised
+// time). The first letter is the most significant bit of each word. A Lyndon
+// word k is the smallest rotation of its necklace, so it names the cyclotomic
+// coset {k, 2k, 4k, ...} modulo 2^n - 1 of size exactly n.
+vector<uint64_t> lyndonWords(int n) {
+    vector<uint64_t> res;
+    vector<int> word = {0};
+
+    while (!word.empty()) {
+        int len = word.size();
+        if (len == n) {
+            uint64_t k = 0;
+            for (int letter : word) {
+                k = (k << 1) | letter;
+            }
+            res.push_back(k);
+        }
+
+        while ((int)word.size() < n) {
+            word.push_back(word[word.size() - len]);
+        }
+        while (!word.empty() && word.back() == 1) {
+            word.pop_back();
+        }
+        if (!word.empty()) {
+            word.back() = 1;
+        }
     }
-    int maxDegree = degree(polynomials[0]);
-    for (const Polynomial& i : polynomials) {
-        maxDegree = max(maxDegree, degree(i));
+
+    return res;
+}
+
+// Smallest cyclic rotation of the n-bit word k.
+uint64_t necklace(uint64_t k, int n) {
+    uint64_t mask = (n == SIZE) ? ~0ULL : (1ULL << n) - 1;
+    uint64_t best = k;
+    for (int i = 1; i < n; i++) {
+        k = ((k << 1) | (k >> (n - 1))) & mask;
+        best = min(best, k);
     }
+    return best;
+}
 
-    for (const Polynomial& i : polynomials) {
-        prettyPrint(i, maxDegree);
+// Candidates of degree deg with one representative per reciprocal pair.
+// Polynomials with a zero constant term (divisible by x) and polynomials of
+// even weight (divisible by x + 1) are never generated. Each result holds the
+// representative and its reciprocal, which are equal for self-reciprocal
+// candidates.
+vector<pair<Polynomial, Polynomial>> canonicalCandidates(int deg) {
+    vector<pair<Polynomial, Polynomial>> res;
+    if (deg < 2 || deg >= SIZE) {
+        return res;
+    }
+
+    uint64_t ends = (1ULL << deg) | 1;
+    uint64_t middleCount = 1ULL << (deg - 1);
+    for (uint64_t middle = 0; middle < middleCount; middle++) {
+        if (__builtin_popcountll(middle) % 2 == 0) {
+            continue;
+        }
+
+        uint64_t reversed = reverseBits(middle) >> (SIZE - deg + 1);
+        if (reversed < middle) {
+            continue;
+        }
+
+        res.push_back({Polynomial(ends | (middle << 1)),
+                       Polynomial(ends | (reversed << 1))});
+    }
+
+    return res;
+}
+
+// Primitive polynomials of degree deg, one pair per reciprocal class.
+vector<pair<Polynomial, Polynomial>> findPrimitivePolynomials(int deg) {
+    vector<pair<Polynomial, Polynomial>> candidates = canonicalCandidates(deg);
+    vector<uint8_t> primitive(candidates.size());
+    threadPool().parallelFor(0, candidates.size(), [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; i++) {
+            primitive[i] = isPrimitive(candidates[i].first);
+        }
+    });
+
+    vector<pair<Polynomial, Polynomial>> res;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (primitive[i]) {
+            res.push_back(candidates[i]);
+        }
+    }
+    return res;
+}
+
+uint64_t fieldMultiply(uint64_t a, uint64_t b, const vector<Polynomial>& field,
+                       const vector<uint64_t>& logOf) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    uint64_t order = field.size() - 1;
+    return field[(logOf[a] + logOf[b]) % order + 1].to_ullong();
+}
+
+// Minimal polynomial of alpha^k over GF(2), where field is the output of
+// findFieldElements and logOf maps an element to its discrete logarithm.
+Polynomial minimalPolynomial(uint64_t k, const vector<Polynomial>& field,
+                             const vector<uint64_t>& logOf) {
+    uint64_t order = field.size() - 1;
+    int deg = __builtin_ctzll(field.size());
+
+    // Coefficients are elements of GF(2^deg) until the product is complete.
+    vector<uint64_t> coefficients = {1};
+    uint64_t exponent = k % order;
+    for (int i = 0; i < deg; i++) {
+        uint64_t root = field[exponent + 1].to_ullong();
+        coefficients.push_back(0);
+        for (int j = coefficients.size() - 1; j > 0; j--) {
+            coefficients[j] =
+                coefficients[j - 1] ^
+                fieldMultiply(coefficients[j], root, field, logOf);
+        }
+        coefficients[0] = fieldMultiply(coefficients[0], root, field, logOf);
+
+        exponent = exponent * 2 % order;
+        if (exponent == k % order) {
+            break;
+        }
     }
+
+    Polynomial res;
+    for (size_t j = 0; j < coefficients.size(); j++) {
+        res[j] = coefficients[j] != 0;
+    }
+    return res;
 }
 
+// All primitive polynomials of the degree of p, without testing any of them:
+// they are the minimal polynomials of alpha^k for the Lyndon words k coprime
+// to 2^deg - 1. Every pair holds a polynomial and its reciprocal, the minimal
+// polynomial of alpha^-k.
 // The polynomial p is assumed to be primitive
-void printField(const Polynomial& p) {
+vector<pair<Polynomial, Polynomial>> primitivePolynomialsFromLyndonWords(
+    const Polynomial& p) {
+    int deg = degree(p);
     vector<Polynomial> field = findFieldElements(p);
+    uint64_t order = field.size() - 1;
 
-    cout << "Field size: " << field.size() << '\n';
-    cout << "Field elements:\n";
-    cout << "----------------------------------\n";
-    prettyPrint(field);
-    cout << "----------------------------------\n";
-}
+    vector<uint64_t> logOf(field.size());
+    for (uint64_t i = 0; i < order; i++) {
+        logOf[field[i + 1].to_ullong()] = i;
+    }
 
-void runApplication(vector<Polynomial>& candidates) {
-    bool found = false;
-    for (Polynomial& p : candidates) {
-        if (!isPrimitive(p)) {
+    vector<pair<Polynomial, Polynomial>> res;
+    for (uint64_t k : lyndonWords(deg)) {
+        uint64_t inverse = necklace(order - k, deg);
+        if (inverse < k || gcd(k, order) != 1) {
             continue;
         }
+        res.push_back({minimalPolynomial(k, field, logOf),
+                       minimalPolynomial(inverse, field, logOf)});
+    }
+    return res;
+}
 
-        found = true;
-        cout << "Found primitive polynomial: ";
-        prettyPrint(p);
-        printField(p);
-        break;
+// Polynomials held in one unsigned integer: uint8_t, uint16_t, uint32_t,
+// uint64_t or unsigned __int128. They behave like Polynomial (products are
+// truncated to the width, the zero polynomial has degree 0) but compile to
+// plain register operations.
+template <class Word>
+struct SmallPolynomial {
+    Word bits;
+};
+
+// Picks the narrowest SmallPolynomial that holds a polynomial of degree
+// Degree, e.g. SmallPolynomialFor<8> for the modulus of GF(2^8).
+template <int Degree>
+using SmallPolynomialFor = SmallPolynomial<conditional_t<
+    Degree <= 7, uint8_t,
+    conditional_t<Degree <= 15, uint16_t,
+                  conditional_t<Degree <= 31, uint32_t,
+                                conditional_t<Degree <= 63, uint64_t,
+                                              unsigned __int128>>>>>;
+
+template <class Word>
+int highestBit(Word a) {
+    if constexpr (sizeof(Word) > sizeof(uint64_t)) {
+        uint64_t high = (uint64_t)(a >> 64);
+        if (high != 0) {
+            return 127 - __builtin_clzll(high);
+        }
     }
+    return 63 - __builtin_clzll((uint64_t)a);
+}
 
-    if (!found) {
-        cout << "None of the candidate polynomials are primitive.\n";
+template <class Word>
+bool operator==(SmallPolynomial<Word> a, SmallPolynomial<Word> b) {
+    return a.bits == b.bits;
+}
+
+template <class Word>
+bool operator!=(SmallPolynomial<Word> a, SmallPolynomial<Word> b) {
+    return a.bits != b.bits;
+}
+
+template <class Word>
+int degree(SmallPolynomial<Word> a) {
+    return a.bits == 0 ? 0 : highestBit(a.bits);
+}
+
+template <class Word>
+SmallPolynomial<Word> operator+(SmallPolynomial<Word> a,
+                                SmallPolynomial<Word> b) {
+    return {(Word)(a.bits ^ b.bits)};
+}
+
+template <class Word>
+SmallPolynomial<Word> operator*(SmallPolynomial<Word> a,
+                                SmallPolynomial<Word> b) {
+    Word total = 0;
+    for (int i = 0; i < (int)sizeof(Word) * 8; i++) {
+        Word mask = (Word)0 - (Word)((a.bits >> i) & 1);
+        total ^= (Word)(b.bits << i) & mask;
     }
+    return {total};
 }
 
-void testRemainder() {
-    cout << "Remainder tests:\n";
-    cout << (Polynomial(0b11111101111110) % Polynomial(0b100011011) ==
-             Polynomial(1));
-    cout << '\n';
+template <class Word>
+SmallPolynomial<Word> operator%(SmallPolynomial<Word> a,
+                                SmallPolynomial<Word> b) {
+    Word rem = a.bits;
+    int bDeg = degree(b);
+    while (rem != 0 && highestBit(rem) >= bDeg) {
+        rem ^= (Word)(b.bits << (highestBit(rem) - bDeg));
+    }
+    return {rem};
 }
 
-void testAddition() {
-    cout << "Addition tests:\n";
-    cout << (Polynomial(0b101) + Polynomial(0b11) == Polynomial(0b110));
-    cout << (Polynomial(0) + Polynomial(0b11011) == Polynomial(0b11011));
-    cout << '\n';
+// a * b mod p, reducing after every shift so that nothing wider than p is
+// ever formed. Works up to a modulus that fills the whole word.
+template <class Word>
+SmallPolynomial<Word> mulMod(SmallPolynomial<Word> a, SmallPolynomial<Word> b,
+                             SmallPolynomial<Word> p) {
+    int deg = degree(p);
+    Word res = 0;
+    for (int i = deg - 1; i >= 0; i--) {
+        Word overflow = (Word)0 - (Word)((res >> (deg - 1)) & 1);
+        res = (Word)(res << 1) ^ (p.bits & overflow);
+        res ^= a.bits & ((Word)0 - (Word)((b.bits >> i) & 1));
+    }
+    return {res};
 }
 
-void testMultiplication() {
-    cout << "Multiplication tests:\n";
-    Polynomial p1(0b101);
-    Polynomial p2(0b11);
-    Polynomial p3(0);
+template <class Word>
+SmallPolynomial<Word> toSmallPolynomial(const Polynomial& a) {
+    return {(Word)a.to_ullong()};
+}
 
-    cout << (p1 * p2 == Polynomial(0b1111));
-    cout << (p2 * p2 == Polynomial(0b101));
-    cout << (p1 * p3 == p3);
+template <class Word>
+Polynomial toPolynomial(SmallPolynomial<Word> a) {
+    return Polynomial((unsigned long long)a.bits);
+}
 
-    cout << '\n';
+// The polynomial p is assumed to be primitive
+template <class Word>
+vector<SmallPolynomial<Word>> findFieldElements(SmallPolynomial<Word> p) {
+    SmallPolynomial<Word> first{1};
+    SmallPolynomial<Word> alpha{2};
+    vector<SmallPolynomial<Word>> res = {{0}, first};
+    SmallPolynomial<Word> current = alpha;
+
+    while (current != first) {
+        res.push_back(current);
+        current = mulMod(current, alpha, p);
+    }
+
+    return res;
 }
 
-void testFindFieldElements() {
-    Polynomial a(0b11001);
-    vector<Polynomial> elements = findFieldElements(Polynomial(0b11001));
-    prettyPrint(elements);
+// Integer arithmetic modulo n for factoring the order of the multiplicative
+// group, on uint64_t or, for degrees above 64, on unsigned __int128.
+uint64_t mulModInteger(uint64_t a, uint64_t b, uint64_t n) {
+    return (unsigned __int128)a * b % n;
+}
 
-    cout << isPrimitive(a) << '\n';
+// a * b mod n for a, b < n, by doubling and adding since there is no wider
+// type for the product, or in 64 bits when n fits.
+unsigned __int128 mulModInteger(unsigned __int128 a, unsigned __int128 b,
+                                unsigned __int128 n) {
+    if ((n >> 64) == 0) {
+        return mulModInteger((uint64_t)a, (uint64_t)b, (uint64_t)n);
+    }
+    auto addMod = [&](unsigned __int128 x, unsigned __int128 y) {
+        return x >= n - y ? x - (n - y) : x + y;
+    };
+    unsigned __int128 res = 0;
+    for (; b > 0; b >>= 1) {
+        if (b & 1) {
+            res = addMod(res, a);
+        }
+        a = addMod(a, a);
+    }
+    return res;
 }
 
-void testApplication() {
-    vector<Polynomial> candidates{Polynomial("1000001"), Polynomial("1001001"),
-                                  Polynomial("1100001")};
-    runApplication(candidates);
+template <class Integer>
+Integer powModInteger(Integer a, Integer e, Integer n) {
+    Integer res = 1 % n;
+    for (; e > 0; e >>= 1) {
+        if (e & 1) {
+            res = mulModInteger(res, a, n);
+        }
+        a = mulModInteger(a, a, n);
+    }
+    return res;
 }
 
-void runTests() {
-    testAddition();
-    testMultiplication();
-    testRemainder();
-    testFindFieldElements();
-    testApplication();
+template <class Integer>
+Integer gcdInteger(Integer a, Integer b) {
+    while (b != 0) {
+        Integer r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
 }
 
-vector<Polynomial> readInput() {
-    cout << "Polynomials are displayed in degree increasing order.\n\n";
+// Miller-Rabin with the first twelve primes as bases, which is exact below
+// 2^64. Above that it is a probable-prime test, which holds for the factors
+// of every group order up to degree 127.
+template <class Integer>
+bool isPrimeInteger(Integer n) {
+    const int bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    if (n < 2) {
+        return false;
+    }
+    for (Integer b : bases) {
+        if (n % b == 0) {
+            return n == b;
+        }
+    }
+    int shift = 0;
+    Integer odd = n - 1;
+    for (; (odd & 1) == 0; odd >>= 1) {
+        shift++;
+    }
+    for (Integer b : bases) {
+        Integer x = powModInteger(b, odd, n);
+        bool passes = x == 1 || x == n - 1;
+        for (int i = 1; i < shift && !passes; i++) {
+            x = mulModInteger(x, x, n);
+            passes = x == n - 1;
+        }
+        if (!passes) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    cout << "Enter degree of polynomials you want to use to generate the "
-            "field: ";
-    int deg;
-    cin >> deg;
+// The 256-bit product of a and b as its high and low halves.
+void mulWide(unsigned __int128 a, unsigned __int128 b,
+             unsigned __int128& high, unsigned __int128& low) {
+    uint64_t a0 = a, a1 = a >> 64, b0 = b, b1 = b >> 64;
+    unsigned __int128 p00 = (unsigned __int128)a0 * b0;
+    unsigned __int128 p01 = (unsigned __int128)a0 * b1;
+    unsigned __int128 p10 = (unsigned __int128)a1 * b0;
+    unsigned __int128 p11 = (unsigned __int128)a1 * b1;
+    unsigned __int128 middle = (p00 >> 64) + (uint64_t)p01 + (uint64_t)p10;
+    low = (middle << 64) | (uint64_t)p00;
+    high = p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64);
+}
 
-    cout << "Enter primitive polynomial candidates count: ";
-    int count;
-    cin >> count;
+// Montgomery's a * b / 2^128 mod n for odd n < 2^127 and a, b < n, where
+// negInverse * n = -1 mod 2^128. It needs no division.
+unsigned __int128 montgomeryMul(unsigned __int128 a, unsigned __int128 b,
+                                unsigned __int128 n,
+                                unsigned __int128 negInverse) {
+    unsigned __int128 high, low, carryHigh, carryLow;
+    mulWide(a, b, high, low);
+    // low + carryLow is 0 mod 2^128 and carries out unless low is 0
+    mulWide(low * negInverse, n, carryHigh, carryLow);
+    unsigned __int128 res = high + carryHigh + (low != 0);
+    return res >= n ? res - n : res;
+}
 
-    cout << "Enter polynomials in binary format in increasing degree order "
-            "seperately on new lines:\n";
-    vector<Polynomial> candidates(count);
-    for (int i = 0; i < count; i++) {
-        string polynomial;
-        cin >> polynomial;
-        if (polynomial.size() != deg + 1 || polynomial.back() != '1') {
-            cout << "Invalid polynomial input!\n";
-            return {};
+// A nontrivial factor of the odd composite n by Pollard's rho, with Brent's
+// cycle search: the differences are multiplied together and only every
+// 128th product goes through a gcd, retracing the last block if that
+// collapses to n. Any multiplication that is the product times a fixed
+// unit mod n serves, so moduli beyond 64 bits use montgomeryMul.
+template <class Integer>
+Integer pollardRho(Integer n) {
+    Integer negInverse = 0;
+    if constexpr (sizeof(Integer) > sizeof(uint64_t)) {
+        if ((n >> 64) == 0) {
+            return pollardRho((uint64_t)n);
+        }
+        // Newton's iteration doubles the correct low bits from the 3 of n
+        Integer inverse = n;
+        for (int i = 0; i < 6; i++) {
+            inverse *= 2 - n * inverse;
+        }
+        negInverse = -inverse;
+    }
+    auto mul = [&](Integer a, Integer b) {
+        if constexpr (sizeof(Integer) > sizeof(uint64_t)) {
+            return montgomeryMul(a, b, n, negInverse);
+        } else {
+            return mulModInteger(a, b, n);
+        }
+    };
+    for (Integer c = 1;; c++) {
+        auto step = [&](Integer x) {
+            x = mul(x, x);
+            return x >= n - c ? x - (n - c) : x + c;
+        };
+        auto distance = [](Integer x, Integer y) {
+            return x > y ? x - y : y - x;
+        };
+        Integer x = 2, y = 2, saved = 2, product = 1, d = 1;
+        for (uint64_t length = 1; d == 1; length *= 2) {
+            x = y;
+            for (uint64_t i = 0; i < length; i++) {
+                y = step(y);
+            }
+            for (uint64_t done = 0; done < length && d == 1; done += 128) {
+                saved = y;
+                for (uint64_t i = done; i < min(length, done + 128); i++) {
+                    y = step(y);
+                    product = mul(product, distance(x, y));
+                }
+                d = gcdInteger(product, n);
+            }
+        }
+        for (d = 1; d == 1;) {
+            saved = step(saved);
+            d = gcdInteger(distance(x, saved), n);
+        }
+        if (d != n) {
+            return d;
         }
-        reverse(polynomial.begin(), polynomial.end());
-        candidates[i] = Polynomial(polynomial);
     }
+}
 
-    return candidates;
+// The distinct prime factors of n, in increasing order.
+template <class Integer>
+vector<Integer> primeFactors(Integer n) {
+    vector<Integer> res;
+    for (Integer d = 2; d < 1000 && d * d <= n; d++) {
+        if (n % d == 0) {
+            res.push_back(d);
+            while (n % d == 0) {
+                n /= d;
+            }
+        }
+    }
+    vector<Integer> pending;
+    if (n > 1) {
+        pending.push_back(n);
+    }
+    while (!pending.empty()) {
+        Integer m = pending.back();
+        pending.pop_back();
+        if (isPrimeInteger(m)) {
+            res.push_back(m);
+            continue;
+        }
+        Integer d = pollardRho(m);
+        pending.push_back(d);
+        pending.push_back(m / d);
+    }
+    sort(res.begin(), res.end());
+    res.erase(unique(res.begin(), res.end()), res.end());
+    return res;
 }
 
-int main() {
-    if (RUN_TESTS) {
-        runTests();
+// The distinct prime factors of 2^deg - 1. That is the product over the
+// divisors d of deg of Phi_d(2), with Phi_d the cyclotomic polynomials, and
+// each of these is factored on its own: together two of them can hold
+// prime factors too large for Pollard's rho, like 2^61 - 1 and
+// (2^61 + 1) / 3 in 2^122 - 1.
+template <class Integer>
+vector<Integer> mersennePrimeFactors(int deg) {
+    vector<Integer> cyclotomic(deg + 1), res;
+    for (int d = 1; d <= deg; d++) {
+        if (deg % d != 0) {
+            continue;
+        }
+        cyclotomic[d] = ~(Integer)0 >> (8 * sizeof(Integer) - d);
+        for (int e = 1; e < d; e++) {
+            if (d % e == 0) {
+                cyclotomic[d] /= cyclotomic[e];
+            }
+        }
+        vector<Integer> factors = primeFactors(cyclotomic[d]);
+        res.insert(res.end(), factors.begin(), factors.end());
+    }
+    sort(res.begin(), res.end());
+    res.erase(unique(res.begin(), res.end()), res.end());
+    return res;
+}
+
+template <class Word, class Integer>
+SmallPolynomial<Word> powerMod(SmallPolynomial<Word> a, Integer e,
+                               SmallPolynomial<Word> p) {
+    SmallPolynomial<Word> res{1};
+    for (; e > 0; e >>= 1) {
+        if (e & 1) {
+            res = mulMod(res, a, p);
+        }
+        a = mulMod(a, a, p);
+    }
+    return res;
+}
+
+// x generates the multiplicative group iff x^order = 1 and
+// x^(order / r) != 1 for every prime r dividing order = 2^deg - 1; an
+// element of that order also shows the quotient ring to be a field.
+template <class Word, class Integer>
+bool generatesGroup(SmallPolynomial<Word> p, int deg) {
+    SmallPolynomial<Word> first{1};
+    SmallPolynomial<Word> alpha{2};
+    Integer order = ~(Integer)0 >> (8 * sizeof(Integer) - deg);
+    if (powerMod(alpha, order, p) != first) {
+        return false;
+    }
+    for (Integer r : mersennePrimeFactors<Integer>(deg)) {
+        if (powerMod(alpha, order / r, p) == first) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The order is factored in 64 bits up to degree 64 and in 128 bits above,
+// which covers every degree a SmallPolynomial holds.
+template <class Word>
+bool isPrimitive(SmallPolynomial<Word> p) {
+    int deg = degree(p);
+
+    if (deg < 2) {
+        return false;
+    }
+    if (deg <= 64) {
+        return generatesGroup<Word, uint64_t>(p, deg);
+    }
+    return generatesGroup<Word, unsigned __int128>(p, deg);
+}
+
+// Scratch memory for the multi-word arithmetic. An allocation bumps an offset
+// into a block and an ArenaScope hands back everything allocated during its
+// lifetime when it ends, so once the blocks have grown to the working size
+// temporaries no longer reach the heap. Every thread has its own arena.
+struct Arena {
+    vector<unique_ptr<char[]>> blocks;
+    vector<size_t> sizes;
+    // The block being filled and the bytes used in it.
+    size_t block = 0;
+    size_t used = 0;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(max_align_t)) {
+        while (true) {
+            if (block < blocks.size()) {
+                uintptr_t start = (uintptr_t)blocks[block].get();
+                size_t offset =
+                    ((start + used + alignment - 1) & ~(alignment - 1)) -
+                    start;
+                if (offset + bytes <= sizes[block]) {
+                    used = offset + bytes;
+                    return blocks[block].get() + offset;
+                }
+                block++;
+                used = 0;
+                continue;
+            }
+            size_t size = blocks.empty() ? 1 << 16 : 2 * sizes.back();
+            size = max(size, bytes + alignment);
+            blocks.emplace_back(new char[size]);
+            sizes.push_back(size);
+        }
+    }
+
+    // count zeroed words
+    uint64_t* allocateWords(size_t count) {
+        uint64_t* res = (uint64_t*)allocate(count * sizeof(uint64_t));
+        fill(res, res + count, 0);
+        return res;
+    }
+};
+
+Arena& threadArena() {
+    thread_local Arena arena;
+    return arena;
+}
+
+struct ArenaScope {
+    Arena& arena;
+    size_t block;
+    size_t used;
+
+    explicit ArenaScope(Arena& arena = threadArena())
+        : arena(arena), block(arena.block), used(arena.used) {}
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    ~ArenaScope() {
+        arena.block = block;
+        arena.used = used;
+    }
+};
+
+// The arena as a memory resource for pmr containers. Deallocation does
+// nothing; the memory comes back when the enclosing ArenaScope ends.
+struct ArenaResource : pmr::memory_resource {
+    Arena& arena;
+
+    explicit ArenaResource(Arena& arena = threadArena()) : arena(arena) {}
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return arena.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(
+        const pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Polynomials of arbitrary degree. Bit i of words[i / 64] is the coefficient
+// of x^i and the last word is never zero, so the zero polynomial has no words.
+struct BigPolynomial {
+    vector<uint64_t> words;
+};
+
+const int WORD_BITS = 64;
+// Below this many words per operand multiplication is done by schoolbook.
+const int KARATSUBA_THRESHOLD = 16;
+// From this many words per operand on, the three half-size products of
+// Karatsuba's method are computed in parallel.
+const size_t PARALLEL_KARATSUBA_THRESHOLD = 512;
+
+void trim(BigPolynomial& a) {
+    while (!a.words.empty() && a.words.back() == 0) {
+        a.words.pop_back();
+    }
+}
+
+bool isZero(const BigPolynomial& a) { return a.words.empty(); }
+
+bool operator==(const BigPolynomial& a, const BigPolynomial& b) {
+    return a.words == b.words;
+}
+
+int degree(const BigPolynomial& a) {
+    if (isZero(a)) {
+        return 0;
+    }
+    return (a.words.size() - 1) * WORD_BITS + 63 -
+           __builtin_clzll(a.words.back());
+}
+
+BigPolynomial toBigPolynomial(const Polynomial& a) {
+    BigPolynomial res{{a.to_ullong()}};
+    trim(res);
+    return res;
+}
+
+// The polynomial with the given exponents set, e.g. {n, k, 0} for a trinomial.
+BigPolynomial fromExponents(const vector<int>& exponents) {
+    BigPolynomial res;
+    for (int e : exponents) {
+        if ((int)res.words.size() <= e / WORD_BITS) {
+            res.words.resize(e / WORD_BITS + 1);
+        }
+        res.words[e / WORD_BITS] ^= 1ULL << (e % WORD_BITS);
+    }
+    trim(res);
+    return res;
+}
+
+BigPolynomial operator+(const BigPolynomial& a, const BigPolynomial& b) {
+    BigPolynomial res = a.words.size() >= b.words.size() ? a : b;
+    const BigPolynomial& shorter = a.words.size() >= b.words.size() ? b : a;
+    for (size_t i = 0; i < shorter.words.size(); i++) {
+        res.words[i] ^= shorter.words[i];
+    }
+    trim(res);
+    return res;
+}
+
+BigPolynomial operator<<(const BigPolynomial& a, int shift) {
+    if (isZero(a)) {
+        return a;
+    }
+    int wordShift = shift / WORD_BITS;
+    int bitShift = shift % WORD_BITS;
+
+    BigPolynomial res;
+    res.words.assign(a.words.size() + wordShift + 1, 0);
+    for (size_t i = 0; i < a.words.size(); i++) {
+        res.words[i + wordShift] ^= a.words[i] << bitShift;
+        if (bitShift != 0) {
+            res.words[i + wordShift + 1] ^=
+                a.words[i] >> (WORD_BITS - bitShift);
+        }
+    }
+    trim(res);
+    return res;
+}
+
+// Carry-less product of two 64-bit words.
+unsigned __int128 clmul(uint64_t a, uint64_t b) {
+#ifdef __PCLMUL__
+    __m128i product =
+        _mm_clmulepi64_si128(_mm_cvtsi64_si128(a), _mm_cvtsi64_si128(b), 0);
+    uint64_t halves[2];
+    _mm_storeu_si128((__m128i*)halves, product);
+    return ((unsigned __int128)halves[1] << 64) | halves[0];
+#else
+    unsigned __int128 res = 0;
+    for (int i = 0; i < WORD_BITS; i++) {
+        unsigned __int128 mask = -(unsigned __int128)((a >> i) & 1);
+        res ^= ((unsigned __int128)b << i) & mask;
+    }
+    return res;
+#endif
+}
+
+// out[0, an + bn) ^= a * b
+void mulSchoolbook(const uint64_t* a, size_t an, const uint64_t* b, size_t bn,
+                   uint64_t* out) {
+    for (size_t i = 0; i < an; i++) {
+        if (a[i] == 0) {
+            continue;
+        }
+        for (size_t j = 0; j < bn; j++) {
+            unsigned __int128 product = clmul(a[i], b[j]);
+            out[i + j] ^= (uint64_t)product;
+            out[i + j + 1] ^= (uint64_t)(product >> 64);
+        }
+    }
+}
+
+// out[0, 2n) ^= a * b, where both operands have n words.
+void mulKaratsuba(const uint64_t* a, const uint64_t* b, size_t n,
+                  uint64_t* out) {
+    if (n < (size_t)KARATSUBA_THRESHOLD) {
+        mulSchoolbook(a, n, b, n, out);
+        return;
+    }
+
+    // a = a0 + x^(64 low) a1, where a1 has high >= low words.
+    size_t low = n / 2;
+    size_t high = n - low;
+
+    Arena& arena = threadArena();
+    ArenaScope scope(arena);
+    uint64_t* aSum = arena.allocateWords(high);
+    uint64_t* bSum = arena.allocateWords(high);
+    copy(a + low, a + n, aSum);
+    copy(b + low, b + n, bSum);
+    for (size_t i = 0; i < low; i++) {
+        aSum[i] ^= a[i];
+        bSum[i] ^= b[i];
+    }
+
+    uint64_t* z0 = arena.allocateWords(2 * low);
+    uint64_t* z1 = arena.allocateWords(2 * high);
+    uint64_t* z2 = arena.allocateWords(2 * high);
+    // Each product has its own buffer, so the result is the same whichever
+    // thread computes it.
+    if (n >= PARALLEL_KARATSUBA_THRESHOLD) {
+        threadPool().invoke({
+            [=] { mulKaratsuba(aSum, bSum, high, z1); },
+            [=] { mulKaratsuba(a, b, low, z0); },
+            [=] { mulKaratsuba(a + low, b + low, high, z2); },
+        });
+    } else {
+        mulKaratsuba(a, b, low, z0);
+        mulKaratsuba(a + low, b + low, high, z2);
+        mulKaratsuba(aSum, bSum, high, z1);
+    }
+
+    for (size_t i = 0; i < 2 * low; i++) {
+        z1[i] ^= z0[i];
+        out[i] ^= z0[i];
+    }
+    for (size_t i = 0; i < 2 * high; i++) {
+        z1[i] ^= z2[i];
+        out[i + 2 * low] ^= z2[i];
+    }
+    for (size_t i = 0; i < 2 * high; i++) {
+        out[i + low] ^= z1[i];
+    }
+}
+
+// From this many words per operand on, products go through the additive
+// FFT, which is defined with the field arithmetic further down.
+const size_t GF2_FFT_THRESHOLD = 16384;
+
+void mulFft(const BigPolynomial& a, const BigPolynomial& b,
+            BigPolynomial& out);
+
+// out = a * b, reusing the storage of out. out may be a or b.
+void mulInto(const BigPolynomial& a, const BigPolynomial& b,
+             BigPolynomial& out) {
+    if (isZero(a) || isZero(b)) {
+        out.words.clear();
+        return;
+    }
+    if (min(a.words.size(), b.words.size()) >= GF2_FFT_THRESHOLD) {
+        mulFft(a, b, out);
+        return;
+    }
+
+    Arena& arena = threadArena();
+    ArenaScope scope(arena);
+    size_t an = a.words.size();
+    size_t bn = b.words.size();
+    uint64_t* product;
+    if (min(an, bn) < (size_t)KARATSUBA_THRESHOLD) {
+        product = arena.allocateWords(an + bn);
+        mulSchoolbook(a.words.data(), an, b.words.data(), bn, product);
+    } else {
+        size_t n = max(an, bn);
+        uint64_t* aPadded = arena.allocateWords(n);
+        uint64_t* bPadded = arena.allocateWords(n);
+        product = arena.allocateWords(2 * n);
+        copy(a.words.begin(), a.words.end(), aPadded);
+        copy(b.words.begin(), b.words.end(), bPadded);
+        mulKaratsuba(aPadded, bPadded, n, product);
+    }
+
+    out.words.assign(product, product + an + bn);
+    trim(out);
+}
+
+BigPolynomial operator*(const BigPolynomial& a, const BigPolynomial& b) {
+    BigPolynomial res;
+    mulInto(a, b, res);
+    return res;
+}
+
+// Spreads the 32 bits of a to the even bit positions of the result.
+uint64_t spreadBits(uint32_t a) {
+    uint64_t x = a;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+}
+
+// Squaring over GF(2) is linear: it only spreads the coefficients apart.
+BigPolynomial square(const BigPolynomial& a) {
+    BigPolynomial res;
+    res.words.resize(2 * a.words.size());
+    for (size_t i = 0; i < a.words.size(); i++) {
+        res.words[2 * i] = spreadBits((uint32_t)a.words[i]);
+        res.words[2 * i + 1] = spreadBits((uint32_t)(a.words[i] >> 32));
+    }
+    trim(res);
+    return res;
+}
+
+// a = a mod p
+void reduceInPlace(BigPolynomial& a, const BigPolynomial& p) {
+    int pDeg = degree(p);
+    if (isZero(a) || degree(a) < pDeg) {
+        return;
+    }
+
+    // Shifted copies of p, so that every step is a whole-word XOR. Shift s
+    // occupies the first (pDeg + s) / 64 + 1 words of its row.
+    Arena& arena = threadArena();
+    ArenaScope scope(arena);
+    size_t width = p.words.size() + 1;
+    uint64_t* shifted = arena.allocateWords(WORD_BITS * width);
+    for (int s = 0; s < WORD_BITS; s++) {
+        uint64_t* row = shifted + s * width;
+        for (size_t j = 0; j < p.words.size(); j++) {
+            row[j] ^= p.words[j] << s;
+            if (s != 0) {
+                row[j + 1] ^= p.words[j] >> (WORD_BITS - s);
+            }
+        }
+    }
+
+    for (int i = degree(a); i >= pDeg; i--) {
+        if (!((a.words[i / WORD_BITS] >> (i % WORD_BITS)) & 1)) {
+            continue;
+        }
+        int shift = i - pDeg;
+        const uint64_t* row = shifted + (shift % WORD_BITS) * width;
+        size_t len = (pDeg + shift % WORD_BITS) / WORD_BITS + 1;
+        size_t offset = shift / WORD_BITS;
+        for (size_t j = 0; j < len; j++) {
+            a.words[offset + j] ^= row[j];
+        }
+    }
+
+    trim(a);
+}
+
+BigPolynomial operator%(const BigPolynomial& a, const BigPolynomial& b) {
+    BigPolynomial rem = a;
+    reduceInPlace(rem, b);
+    return rem;
+}
+
+// Polynomials with few nonzero coefficients, as their exponents in decreasing
+// order. A trinomial of degree 100000 takes three ints instead of 12.5 KB and
+// its degree is read off in constant time.
+struct SparsePolynomial {
+    vector<int> exponents;
+};
+
+bool isZero(const SparsePolynomial& a) { return a.exponents.empty(); }
+
+bool operator==(const SparsePolynomial& a, const SparsePolynomial& b) {
+    return a.exponents == b.exponents;
+}
+
+int degree(const SparsePolynomial& a) {
+    return isZero(a) ? 0 : a.exponents[0];
+}
+
+SparsePolynomial toSparse(const BigPolynomial& a) {
+    SparsePolynomial res;
+    for (size_t i = a.words.size(); i-- > 0;) {
+        uint64_t word = a.words[i];
+        while (word != 0) {
+            int bit = 63 - __builtin_clzll(word);
+            res.exponents.push_back(i * WORD_BITS + bit);
+            word ^= 1ULL << bit;
+        }
+    }
+    return res;
+}
+
+BigPolynomial toDense(const SparsePolynomial& a) {
+    return fromExponents(a.exponents);
+}
+
+const BigPolynomial& toDense(const BigPolynomial& a) { return a; }
+
+// Sparse arithmetic costs a pass over the other operand per term, so it only
+// pays off while there are fewer terms than words in the dense form.
+bool prefersDense(const SparsePolynomial& a) {
+    return a.exponents.size() > (size_t)degree(a) / WORD_BITS + 1;
+}
+
+// Sorts the exponents in decreasing order and cancels equal pairs.
+void normalize(SparsePolynomial& a) {
+    sort(a.exponents.rbegin(), a.exponents.rend());
+    vector<int> res;
+    for (int e : a.exponents) {
+        if (!res.empty() && res.back() == e) {
+            res.pop_back();
+        } else {
+            res.push_back(e);
+        }
+    }
+    a.exponents = res;
+}
+
+SparsePolynomial operator+(const SparsePolynomial& a,
+                           const SparsePolynomial& b) {
+    SparsePolynomial res{a.exponents};
+    res.exponents.insert(res.exponents.end(), b.exponents.begin(),
+                         b.exponents.end());
+    normalize(res);
+    return res;
+}
+
+SparsePolynomial operator*(const SparsePolynomial& a,
+                           const SparsePolynomial& b) {
+    SparsePolynomial res;
+    for (int i : a.exponents) {
+        for (int j : b.exponents) {
+            res.exponents.push_back(i + j);
+        }
+    }
+    normalize(res);
+    return res;
+}
+
+// w ^= t * x^offset
+void xorShifted(vector<uint64_t>& w, uint64_t t, long long offset) {
+    size_t word = offset / WORD_BITS;
+    int bit = offset % WORD_BITS;
+    w[word] ^= t << bit;
+    if (bit != 0) {
+        w[word + 1] ^= t >> (WORD_BITS - bit);
+    }
+}
+
+BigPolynomial operator*(const SparsePolynomial& a, const BigPolynomial& b) {
+    if (prefersDense(a)) {
+        return toDense(a) * b;
+    }
+
+    BigPolynomial res;
+    if (isZero(a) || isZero(b)) {
+        return res;
+    }
+    res.words.assign(b.words.size() + degree(a) / WORD_BITS + 1, 0);
+    for (int e : a.exponents) {
+        for (size_t j = 0; j < b.words.size(); j++) {
+            xorShifted(res.words, b.words[j], j * WORD_BITS + e);
+        }
+    }
+    trim(res);
+    return res;
+}
+
+BigPolynomial operator*(const BigPolynomial& a, const SparsePolynomial& b) {
+    return b * a;
+}
+
+// Whether reduceSparse applies: every exponent but the leading one lies at
+// least a word below it, so a folded word never lands on itself.
+bool reducesSparsely(const SparsePolynomial& p) {
+    return !isZero(p) && !prefersDense(p) &&
+           (p.exponents.size() < 2 ||
+            p.exponents[0] - p.exponents[1] >= WORD_BITS);
+}
+
+// Reduces w modulo p in place one word at a time from the top: for
+// p = x^n + sum x^e, the coefficients at x^i fold onto x^(i - n + e).
+void reduceSparse(vector<uint64_t>& w, const SparsePolynomial& p) {
+    int n = degree(p);
+    size_t top = n / WORD_BITS;
+    if (w.size() <= top) {
+        return;
+    }
+
+    for (size_t i = w.size() - 1; i > top; i--) {
+        uint64_t t = w[i];
+        if (t == 0) {
+            continue;
+        }
+        w[i] = 0;
+        long long offset = (long long)i * WORD_BITS - n;
+        for (size_t j = 1; j < p.exponents.size(); j++) {
+            xorShifted(w, t, offset + p.exponents[j]);
+        }
+    }
+
+    int bit = n % WORD_BITS;
+    uint64_t t = w[top] >> bit;
+    if (t != 0) {
+        w[top] &= (1ULL << bit) - 1;
+        for (size_t j = 1; j < p.exponents.size(); j++) {
+            xorShifted(w, t, p.exponents[j]);
+        }
+    }
+}
+
+void reduceInPlace(BigPolynomial& a, const SparsePolynomial& p) {
+    if (!reducesSparsely(p)) {
+        reduceInPlace(a, toDense(p));
+        return;
+    }
+    reduceSparse(a.words, p);
+    trim(a);
+}
+
+BigPolynomial operator%(const BigPolynomial& a, const SparsePolynomial& p) {
+    BigPolynomial rem = a;
+    reduceInPlace(rem, p);
+    return rem;
+}
+
+// The modular operations below accept a dense BigPolynomial modulus or a
+// SparsePolynomial one.
+template <class Modulus>
+BigPolynomial mulMod(const BigPolynomial& a, const BigPolynomial& b,
+                     const Modulus& p) {
+    BigPolynomial res;
+    mulInto(a, b, res);
+    reduceInPlace(res, p);
+    return res;
+}
+
+template <class Modulus>
+BigPolynomial squareMod(const BigPolynomial& a, const Modulus& p) {
+    BigPolynomial res = square(a);
+    reduceInPlace(res, p);
+    return res;
+}
+
+BigPolynomial gcd(BigPolynomial a, BigPolynomial b) {
+    while (!isZero(b)) {
+        BigPolynomial rem = a % b;
+        a = b;
+        b = rem;
+    }
+    return a;
+}
+
+// g(h) mod p by Brent-Kung baby-step/giant-step: g is split into blocks of m
+// coefficients, each block is evaluated at h from the baby steps h^0..h^(m-1)
+// (over GF(2) this is only XORs) and the blocks are combined by Horner's rule
+// in h^m. That costs about 2 * sqrt(deg g) multiplications instead of deg g.
+template <class Modulus>
+BigPolynomial composeMod(const BigPolynomial& g, const BigPolynomial& h,
+                         const Modulus& p) {
+    if (isZero(g)) {
+        return g;
+    }
+    int count = degree(g) + 1;
+    int m = 1;
+    while (m * m < count) {
+        m++;
+    }
+
+    vector<BigPolynomial> baby(m);
+    baby[0] = fromExponents({0}) % p;
+    BigPolynomial hRem = h % p;
+    for (int i = 1; i < m; i++) {
+        baby[i] = mulMod(baby[i - 1], hRem, p);
+    }
+    BigPolynomial giant = mulMod(baby[m - 1], hRem, p);
+
+    size_t width = degree(p) / WORD_BITS + 1;
+    BigPolynomial res;
+    for (int block = (count - 1) / m; block >= 0; block--) {
+        BigPolynomial blockValue;
+        blockValue.words.assign(width, 0);
+        for (int i = 0; i < m && block * m + i < count; i++) {
+            int bit = block * m + i;
+            if (!((g.words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1)) {
+                continue;
+            }
+            for (size_t j = 0; j < baby[i].words.size(); j++) {
+                blockValue.words[j] ^= baby[i].words[j];
+            }
+        }
+        trim(blockValue);
+
+        mulInto(res, giant, res);
+        reduceInPlace(res, p);
+        res = res + blockValue;
+    }
+
+    return res;
+}
+
+// x^(2^k) mod p. Writing F_k for the result, F_(a+b) = F_a(F_b) mod p, so
+// doubling k is one modular composition and incrementing it is one squaring.
+// While k is still small, doubling by plain squarings is cheaper.
+template <class Modulus>
+BigPolynomial frobeniusPower(long long k, const Modulus& p) {
+    BigPolynomial x = fromExponents({1}) % p;
+    if (k == 0) {
+        return x;
+    }
+
+    int composeThreshold = 2;
+    while (composeThreshold * composeThreshold < degree(p)) {
+        composeThreshold++;
+    }
+    composeThreshold *= 2;
+
+    int topBit = 63 - __builtin_clzll(k);
+    BigPolynomial res = squareMod(x, p);
+    long long done = 1;
+    for (int bit = topBit - 1; bit >= 0; bit--) {
+        if (done < composeThreshold) {
+            for (long long i = 0; i < done; i++) {
+                res = squareMod(res, p);
+            }
+        } else {
+            res = composeMod(res, res, p);
+        }
+        done *= 2;
+
+        if ((k >> bit) & 1) {
+            res = squareMod(res, p);
+            done++;
+        }
+    }
+
+    return res;
+}
+
+// Rabin's test: p of degree n is irreducible iff x^(2^n) = x mod p and
+// gcd(x^(2^(n/r)) - x, p) = 1 for every prime r dividing n.
+template <class Modulus>
+bool isIrreducible(const Modulus& p) {
+    int n = degree(p);
+    if (isZero(p) || n < 1) {
+        return false;
+    }
+
+    BigPolynomial x = fromExponents({1}) % p;
+    if (!(frobeniusPower(n, p) == x)) {
+        return false;
+    }
+
+    int rest = n;
+    for (int r = 2; r <= rest; r++) {
+        if (rest % r != 0) {
+            continue;
+        }
+        while (rest % r == 0) {
+            rest /= r;
+        }
+        BigPolynomial common = gcd(toDense(p), frobeniusPower(n / r, p) + x);
+        if (!(common == fromExponents({0}))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Mersenne exponents n: 2^n - 1 is prime, so every irreducible polynomial of
+// degree n is primitive.
+const vector<int> MERSENNE_EXPONENTS = {
+    2,    3,    5,    7,    13,   17,    19,    31,    61,    89,    107,
+    127,  521,  607,  1279, 2203, 2281,  3217,  4253,  4423,  9689,  9941,
+    11213, 19937, 21701, 23209, 44497, 86243, 110503, 132049, 216091};
+
+// Swan's theorem: the cases in which x^n + x^k + 1 has an even number of
+// irreducible factors, and is therefore reducible. For n and k both even,
+// where the theorem does not apply, the trinomial is a square.
+bool swanReducible(int n, int k) {
+    if (n % 2 == 1 && k % 2 == 1) {
+        k = n - k;
+    }
+    // Then x^n + x^k + 1 = (x^(n/2) + x^(k/2) + 1)^2.
+    if (n % 2 == 0 && k % 2 == 0) {
+        return true;
+    }
+
+    if (n % 2 == 0) {
+        long long half = (long long)n * k / 2;
+        return n != 2 * k && (half % 4 == 0 || half % 4 == 1);
+    }
+
+    int residue = n % 8;
+    bool plusMinusThree = residue == 3 || residue == 5;
+    bool divides = (2 * n) % k == 0;
+    return divides ? !plusMinusThree : plusMinusThree;
+}
+
+// Irreducible polynomials of degree 1 to maxDegree, used to sieve out
+// candidates with a small factor before the expensive test.
+vector<Polynomial> smallIrreducibles(int maxDegree) {
+    vector<Polynomial> res = {Polynomial(0b10), Polynomial(0b11)};
+    for (int deg = 2; deg <= maxDegree; deg++) {
+        for (uint64_t i = (1ULL << deg) | 1; i < (2ULL << deg); i += 2) {
+            if (isIrreducible(toBigPolynomial(Polynomial(i)))) {
+                res.push_back(Polynomial(i));
+            }
+        }
+    }
+    return res;
+}
+
+// x^n mod q for a small modulus q.
+Polynomial xPowerMod(long long n, const Polynomial& q) {
+    Polynomial res(1);
+    Polynomial base = Polynomial(0b10) % q;
+    while (n > 0) {
+        if (n & 1) {
+            res = res * base % q;
+        }
+        base = base * base % q;
+        n >>= 1;
+    }
+    return res;
+}
+
+// For prime n, x^n + x^k + 1 without roots in GF(2) is irreducible iff
+// x^(2^n) = x modulo it.
+bool isTrinomialIrreducible(int n, int k) {
+    bool prime = n > 1;
+    for (int d = 2; d * d <= n; d++) {
+        prime = prime && n % d != 0;
+    }
+    if (!prime || n - k < WORD_BITS) {
+        return isIrreducible(fromExponents({n, k, 0}));
+    }
+
+    SparsePolynomial trinomial{{n, k, 0}};
+    size_t words = n / WORD_BITS + 1;
+    vector<uint64_t> current(words), squared(2 * words);
+    current[0] = 0b10;
+    for (int i = 0; i < n; i++) {
+        for (size_t j = 0; j < words; j++) {
+            squared[2 * j] = spreadBits((uint32_t)current[j]);
+            squared[2 * j + 1] = spreadBits((uint32_t)(current[j] >> 32));
+        }
+        reduceSparse(squared, trinomial);
+        copy(squared.begin(), squared.begin() + words, current.begin());
+    }
+
+    current[0] ^= 0b10;
+    return all_of(current.begin(), current.end(),
+                  [](uint64_t w) { return w == 0; });
+}
+
+// Exponents 0 < k <= n/2 for which x^n + x^k + 1 is irreducible; the
+// reciprocal x^n + x^(n-k) + 1 is then irreducible too. Candidates are
+// filtered by Swan's theorem and by trial division with the irreducible
+// polynomials of degree up to sieveDegree. If checkpointPath is not empty,
+// every tested candidate is appended to that file and candidates already
+// recorded there are not tested again.
+vector<int> searchTrinomials(int n, const string& checkpointPath = "",
+                             int sieveDegree = 12) {
+    vector<int> status(n / 2 + 1, -1);
+    if (!checkpointPath.empty()) {
+        ifstream checkpoint(checkpointPath);
+        int k, irreducible;
+        while (checkpoint >> k >> irreducible) {
+            if (k > 0 && k <= n / 2) {
+                status[k] = irreducible;
+            }
+        }
+    }
+
+    // x^n and x^k modulo each sieving polynomial, as plain words so that
+    // stepping k is a shift and a conditional XOR.
+    vector<Polynomial> sieve = smallIrreducibles(min(sieveDegree, n - 1));
+    vector<uint64_t> moduli, xnMod, xkMod;
+    vector<int> degrees;
+    for (const Polynomial& q : sieve) {
+        moduli.push_back(q.to_ullong());
+        degrees.push_back(degree(q));
+        xnMod.push_back(xPowerMod(n, q).to_ullong());
+        xkMod.push_back(1);
+    }
+
+    ofstream checkpoint;
+    if (!checkpointPath.empty()) {
+        checkpoint.open(checkpointPath, ios::app);
+    }
+
+    // The sieves run in order of k; the candidates that pass them are tested
+    // in parallel.
+    vector<int> candidates;
+    for (int k = 1; k <= n / 2; k++) {
+        bool hasSmallFactor = false;
+        for (size_t i = 0; i < moduli.size(); i++) {
+            xkMod[i] <<= 1;
+            if ((xkMod[i] >> degrees[i]) & 1) {
+                xkMod[i] ^= moduli[i];
+            }
+            hasSmallFactor = hasSmallFactor || (xnMod[i] ^ xkMod[i]) == 1;
+        }
+
+        if (status[k] != -1) {
+            continue;
+        }
+        if (hasSmallFactor || swanReducible(n, k)) {
+            status[k] = 0;
+            if (checkpoint.is_open()) {
+                checkpoint << k << ' ' << status[k] << endl;
+            }
+        } else {
+            candidates.push_back(k);
+        }
+    }
+
+    mutex checkpointLock;
+    threadPool().parallelFor(0, candidates.size(), [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; i++) {
+            int k = candidates[i];
+            int irreducible = isTrinomialIrreducible(n, k);
+            lock_guard<mutex> guard(checkpointLock);
+            status[k] = irreducible;
+            if (checkpoint.is_open()) {
+                checkpoint << k << ' ' << irreducible << endl;
+            }
+        }
+    });
+
+    vector<int> res;
+    for (int k = 1; k <= n / 2; k++) {
+        if (status[k] == 1) {
+            res.push_back(k);
+        }
+    }
+    return res;
+}
+
+// 64 bits of w starting at bit offset, with zeros past the end.
+uint64_t extractWord(const vector<uint64_t>& w, size_t offset) {
+    size_t word = offset / WORD_BITS;
+    int bit = offset % WORD_BITS;
+    uint64_t res = word < w.size() ? w[word] >> bit : 0;
+    if (bit != 0 && word + 1 < w.size()) {
+        res |= w[word + 1] << (WORD_BITS - bit);
+    }
+    return res;
+}
+
+// Characteristic polynomial x^L + c_1 x^(L-1) + ... + c_L of the shortest
+// linear recurrence s_n = c_1 s_(n-1) + ... + c_L s_(n-L) generating the bit
+// sequence (Berlekamp-Massey). 2L bits of output are enough to find it.
+BigPolynomial berlekampMassey(const vector<uint8_t>& bits) {
+    size_t count = bits.size();
+    size_t words = count / WORD_BITS + 2;
+
+    // Bit count - 1 - j of reversed is s_j, so that s_n, s_(n-1), ... are
+    // consecutive bits and a discrepancy is a masked parity of whole words.
+    vector<uint64_t> reversed(words);
+    for (size_t j = 0; j < count; j++) {
+        if (bits[j]) {
+            size_t position = count - 1 - j;
+            reversed[position / WORD_BITS] |= 1ULL << (position % WORD_BITS);
+        }
+    }
+
+    vector<uint64_t> connection(words), previous(words), saved;
+    connection[0] = previous[0] = 1;
+    int length = 0;
+    long long lastChange = -1;
+    for (size_t n = 0; n < count; n++) {
+        uint64_t discrepancy = 0;
+        for (int w = 0; w <= length / WORD_BITS; w++) {
+            discrepancy ^=
+                connection[w] &
+                extractWord(reversed, count - 1 - n + (size_t)w * WORD_BITS);
+        }
+        if (__builtin_parityll(discrepancy) == 0) {
+            continue;
+        }
+
+        bool lengthens = 2 * length <= (long long)n;
+        if (lengthens) {
+            saved = connection;
+        }
+        int shift = n - lastChange;
+        for (size_t w = 0; (w * WORD_BITS + shift) / WORD_BITS + 1 < words;
+             w++) {
+            if (previous[w] != 0) {
+                xorShifted(connection, previous[w], w * WORD_BITS + shift);
+            }
+        }
+        if (lengthens) {
+            length = n + 1 - length;
+            lastChange = n;
+            previous = saved;
+        }
+    }
+
+    BigPolynomial res;
+    res.words.assign(length / WORD_BITS + 1, 0);
+    for (int i = 0; i <= length; i++) {
+        if ((connection[i / WORD_BITS] >> (i % WORD_BITS)) & 1) {
+            int e = length - i;
+            res.words[e / WORD_BITS] |= 1ULL << (e % WORD_BITS);
+        }
+    }
+    trim(res);
+    return res;
+}
+
+// x^jump mod charPoly. Applied to a generator whose transition has
+// characteristic polynomial charPoly it advances the state by jump steps.
+// Use frobeniusPower(k, charPoly) instead for jumps of 2^k steps.
+template <class Modulus>
+BigPolynomial jumpPolynomial(unsigned long long jump,
+                             const Modulus& charPoly) {
+    BigPolynomial res = fromExponents({0}) % charPoly;
+    for (int bit = 63; bit >= 0; bit--) {
+        res = squareMod(res, charPoly);
+        if ((jump >> bit) & 1) {
+            res = (res << 1) % charPoly;
+        }
+    }
+    return res;
+}
+
+// Mersenne Twister MT19937 in its incremental form, where each output
+// updates one word of the state. It produces the same outputs as
+// std::mt19937. The logical state is the 624 words starting at index.
+struct Mt19937 {
+    static const int N = 624;
+    static const int M = 397;
+    uint32_t mt[N];
+    int index;
+
+    explicit Mt19937(uint32_t seed = 5489) {
+        mt[0] = seed;
+        for (int i = 1; i < N; i++) {
+            mt[i] = 1812433253U * (mt[i - 1] ^ (mt[i - 1] >> 30)) + i;
+        }
+        index = 0;
+    }
+
+    uint32_t next() {
+        int i = index;
+        uint32_t y = (mt[i] & 0x80000000U) | (mt[(i + 1) % N] & 0x7FFFFFFFU);
+        mt[i] = mt[(i + M) % N] ^ (y >> 1) ^ ((y & 1) ? 0x9908B0DFU : 0);
+        index = (i + 1) % N;
+
+        y = mt[i];
+        y ^= y >> 11;
+        y ^= (y << 7) & 0x9D2C5680U;
+        y ^= (y << 15) & 0xEFC60000U;
+        y ^= y >> 18;
+        return y;
+    }
+
+    void clear() { fill(mt, mt + N, 0); }
+
+    Mt19937& operator^=(const Mt19937& other) {
+        for (int j = 0; j < N; j++) {
+            mt[(index + j) % N] ^= other.mt[(other.index + j) % N];
+        }
+        return *this;
+    }
+};
+
+// Lowest output bits of an F2-linear generator, enough of them for
+// berlekampMassey to find a characteristic polynomial of degree up to
+// maxDegree.
+template <class Generator>
+vector<uint8_t> outputBits(Generator generator, int maxDegree) {
+    vector<uint8_t> res(2 * maxDegree);
+    for (uint8_t& bit : res) {
+        bit = generator.next() & 1;
+    }
+    return res;
+}
+
+// The generator advanced by jumpPoly = x^J mod its characteristic
+// polynomial, i.e. by J steps. Horner's rule over GF(2)[x] evaluates
+// jumpPoly(T) at the state, where T is one step of the generator; this needs
+// deg(jumpPoly) steps and state XORs instead of J steps.
+template <class Generator>
+Generator jump(const Generator& generator, const BigPolynomial& jumpPoly) {
+    Generator res = generator;
+    res.clear();
+    if (isZero(jumpPoly)) {
+        return res;
+    }
+    for (int i = degree(jumpPoly); i >= 0; i--) {
+        res.next();
+        if ((jumpPoly.words[i / WORD_BITS] >> (i % WORD_BITS)) & 1) {
+            res ^= generator;
+        }
+    }
+    return res;
+}
+
+// count generators whose sequences start jumpPoly apart, for non-overlapping
+// parallel streams.
+template <class Generator>
+vector<Generator> jumpStreams(const Generator& first, int count,
+                              const BigPolynomial& jumpPoly) {
+    vector<Generator> res = {first};
+    while ((int)res.size() < count) {
+        res.push_back(jump(res.back(), jumpPoly));
+    }
+    return res;
+}
+
+// Arithmetic in GF(2^q) = GF(2)[x] / p for q <= 63. Field elements are the
+// low q bits of a uint64_t. Products are reduced by Barrett's method, which
+// over GF(2) is exact and needs two carry-less multiplications. p must be
+// irreducible for the quotient to be a field; isIrreducible(ctx) checks it.
+struct FieldContext {
+    uint64_t modulus;
+    int deg;
+    // floor(x^(2q) / p)
+    uint64_t barrett;
+    uint64_t mask;
+    // Use kernels whose timing does not depend on the elements, for key
+    // material. Multiplication of uint64_t elements is always constant time;
+    // this selects the constant-time inversion and exponentiation and the
+    // branch-free kernels for Polynomial elements.
+    bool constantTime;
+};
+
+FieldContext makeFieldContext(const Polynomial& p, bool constantTime = false) {
+    FieldContext ctx;
+    ctx.constantTime = constantTime;
+    ctx.modulus = p.to_ullong();
+    ctx.deg = degree(p);
+    ctx.mask = (1ULL << ctx.deg) - 1;
+
+    unsigned __int128 rem = (unsigned __int128)1 << (2 * ctx.deg);
+    ctx.barrett = 0;
+    for (int i = ctx.deg; i >= 0; i--) {
+        if ((rem >> (i + ctx.deg)) & 1) {
+            rem ^= (unsigned __int128)ctx.modulus << i;
+            ctx.barrett |= 1ULL << i;
+        }
+    }
+    return ctx;
+}
+
+bool isIrreducible(const FieldContext& ctx) {
+    return isIrreducible(toBigPolynomial(Polynomial(ctx.modulus)));
+}
+
+// a * b mod p for elements held as Polynomial, of degree below q <= 32 so
+// that the product fits: with mulBranchFree and remBranchFree in
+// constant-time mode, with the operators otherwise.
+Polynomial mulMod(const Polynomial& a, const Polynomial& b,
+                  const FieldContext& ctx) {
+    Polynomial p(ctx.modulus);
+    if (ctx.constantTime) {
+        return remBranchFree(mulBranchFree(a, b), p);
+    }
+    return a * b % p;
+}
+
+// c mod p for c of degree below 2q.
+uint64_t reduce(unsigned __int128 c, const FieldContext& ctx) {
+    uint64_t high = (uint64_t)(c >> ctx.deg);
+    uint64_t quotient = (uint64_t)(clmul(high, ctx.barrett) >> ctx.deg);
+    return (uint64_t)(c ^ clmul(quotient, ctx.modulus)) & ctx.mask;
+}
+
+uint64_t mulMod(uint64_t a, uint64_t b, const FieldContext& ctx) {
+    return reduce(clmul(a, b), ctx);
+}
+
+// Expression templates for field elements: lazy(a) * lazy(b) + lazy(c) *
+// lazy(d) only records the expression, and % ctx evaluates it with every
+// product left unreduced (below 2q - 1 bits), XORs them and reduces once.
+// Sums of elements can be multiplied; products can only be added.
+struct LazyElement {
+    uint64_t value;
+
+    uint64_t evaluate() const { return value; }
+};
+
+template <class A, class B>
+struct LazySum {
+    A a;
+    B b;
+
+    // uint64_t while both terms are reduced, unsigned __int128 otherwise
+    auto evaluate() const { return a.evaluate() ^ b.evaluate(); }
+};
+
+template <class A, class B>
+struct LazyProduct {
+    A a;
+    B b;
+
+    unsigned __int128 evaluate() const {
+        return clmul(a.evaluate(), b.evaluate());
+    }
+};
+
+template <class T>
+struct IsLazy : false_type {};
+template <>
+struct IsLazy<LazyElement> : true_type {};
+template <class A, class B>
+struct IsLazy<LazySum<A, B>> : true_type {};
+template <class A, class B>
+struct IsLazy<LazyProduct<A, B>> : true_type {};
+
+// Whether the expression is still a field element, so that it can be a
+// factor of a product.
+template <class T>
+constexpr bool isReducedExpression =
+    is_same_v<decltype(declval<T>().evaluate()), uint64_t>;
+
+LazyElement lazy(uint64_t a) { return {a}; }
+
+template <class A, class B,
+          class = enable_if_t<IsLazy<A>::value && IsLazy<B>::value>>
+LazySum<A, B> operator+(const A& a, const B& b) {
+    return {a, b};
+}
+
+template <class A, class B,
+          class = enable_if_t<IsLazy<A>::value && IsLazy<B>::value>,
+          class = enable_if_t<isReducedExpression<A> &&
+                              isReducedExpression<B>>>
+LazyProduct<A, B> operator*(const A& a, const B& b) {
+    return {a, b};
+}
+
+template <class A, class = enable_if_t<IsLazy<A>::value>>
+uint64_t operator%(const A& a, const FieldContext& ctx) {
+    return reduce(a.evaluate(), ctx);
+}
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__VPCLMULQDQ__)
+// Barrett reduction of the four 128-bit products in c, one per 128-bit lane.
+// The results are left in the low qword of each lane. The shifts are the
+// zero-masking forms with all lanes kept: GCC 12 warns about the undefined
+// source operand its headers pass for the unmasked ones.
+__m512i reduceLanes(__m512i c, const FieldContext& ctx) {
+    __m512i right = _mm512_set1_epi64(ctx.deg);
+    __m512i left = _mm512_set1_epi64(WORD_BITS - ctx.deg);
+
+    __m512i high = _mm512_xor_si512(
+        _mm512_maskz_srlv_epi64(0xFF, c, right),
+        _mm512_maskz_sllv_epi64(0xFF, _mm512_bsrli_epi128(c, 8), left));
+    __m512i t = _mm512_clmulepi64_epi128(
+        high, _mm512_set1_epi64(ctx.barrett), 0x00);
+    __m512i quotient = _mm512_xor_si512(
+        _mm512_maskz_srlv_epi64(0xFF, t, right),
+        _mm512_maskz_sllv_epi64(0xFF, _mm512_bsrli_epi128(t, 8), left));
+    __m512i r = _mm512_xor_si512(
+        c, _mm512_clmulepi64_epi128(quotient,
+                                    _mm512_set1_epi64(ctx.modulus), 0x00));
+    return _mm512_and_si512(r, _mm512_set1_epi64(ctx.mask));
+}
+#elif defined(__PCLMUL__)
+// Barrett reduction of the 128-bit product in c, left in the low qword.
+__m128i reduceLane(__m128i c, const FieldContext& ctx) {
+    __m128i right = _mm_cvtsi32_si128(ctx.deg);
+    __m128i left = _mm_cvtsi32_si128(WORD_BITS - ctx.deg);
+
+    __m128i high = _mm_xor_si128(_mm_srl_epi64(c, right),
+                                 _mm_sll_epi64(_mm_srli_si128(c, 8), left));
+    __m128i t = _mm_clmulepi64_si128(
+        high, _mm_set1_epi64x(ctx.barrett), 0x00);
+    __m128i quotient = _mm_xor_si128(
+        _mm_srl_epi64(t, right), _mm_sll_epi64(_mm_srli_si128(t, 8), left));
+    __m128i r = _mm_xor_si128(
+        c, _mm_clmulepi64_si128(quotient, _mm_set1_epi64x(ctx.modulus), 0x00));
+    return _mm_and_si128(r, _mm_set1_epi64x(ctx.mask));
+}
+#endif
+
+// a^e, with a multiplication for every bit of e in constant-time mode.
+uint64_t power(uint64_t a, uint64_t e, const FieldContext& ctx) {
+    uint64_t res = 1;
+    for (int i = 63; i >= 0; i--) {
+        res = mulMod(res, res, ctx);
+        uint64_t bit = (e >> i) & 1;
+        if (ctx.constantTime) {
+            uint64_t product = mulMod(res, a, ctx);
+            res ^= (res ^ product) & (0 - bit);
+        } else if (bit) {
+            res = mulMod(res, a, ctx);
+        }
+    }
+    return res;
+}
+
+// a^-1, with 0 mapped to 0. The extended Euclidean algorithm is fastest but
+// its steps depend on a; in constant-time mode a^(2^q - 2) is computed with a
+// fixed chain of q - 1 squarings and q - 2 multiplications instead. Both
+// need an irreducible modulus; with a reducible one, Euclid maps the
+// elements sharing a factor with it to 0 and the chain gives no inverse.
+uint64_t inverse(uint64_t a, const FieldContext& ctx) {
+    if (ctx.constantTime) {
+        uint64_t square = mulMod(a, a, ctx);
+        uint64_t res = square;
+        for (int i = 2; i < ctx.deg; i++) {
+            square = mulMod(square, square, ctx);
+            res = mulMod(res, square, ctx);
+        }
+        return res;
+    }
+
+    if (a == 0) {
+        return 0;
+    }
+    // a * g1 = u and a * g2 = v modulo p throughout.
+    uint64_t u = a, v = ctx.modulus, g1 = 1, g2 = 0;
+    // u reaches 0 instead of 1 when gcd(a, p) != 1.
+    while (u > 1) {
+        int shift = highestBit(u) - highestBit(v);
+        if (shift < 0) {
+            swap(u, v);
+            swap(g1, g2);
+            shift = -shift;
+        }
+        u ^= v << shift;
+        g1 ^= g2 << shift;
+    }
+    return u == 1 ? g1 : 0;
+}
+
+// out[i] = a[i] * b[i] for i < count. With VPCLMULQDQ eight products are
+// formed by two instructions and reduced together; with plain PCLMUL two at
+// a time.
+void mulMod(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t count,
+            const FieldContext& ctx) {
+    size_t i = 0;
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__VPCLMULQDQ__)
+    for (; i + 8 <= count; i += 8) {
+        __m512i va = _mm512_loadu_si512(a + i);
+        __m512i vb = _mm512_loadu_si512(b + i);
+        __m512i even = reduceLanes(_mm512_clmulepi64_epi128(va, vb, 0x00), ctx);
+        __m512i odd = reduceLanes(_mm512_clmulepi64_epi128(va, vb, 0x11), ctx);
+        // The zero-masking form, with all lanes kept, for the same GCC 12
+        // warning as in reduceLanes.
+        _mm512_storeu_si512(out + i,
+                            _mm512_maskz_unpacklo_epi64(0xFF, even, odd));
+    }
+#elif defined(__PCLMUL__)
+    for (; i + 2 <= count; i += 2) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i even = reduceLane(_mm_clmulepi64_si128(va, vb, 0x00), ctx);
+        __m128i odd = reduceLane(_mm_clmulepi64_si128(va, vb, 0x11), ctx);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_unpacklo_epi64(even, odd));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = mulMod(a[i], b[i], ctx);
+    }
+}
+
+// As mulMod, with large batches split between the threads of the pool.
+void mulModParallel(const uint64_t* a, const uint64_t* b, uint64_t* out,
+                    size_t count, const FieldContext& ctx) {
+    const size_t grain = 1 << 14;
+    if (count <= grain) {
+        mulMod(a, b, out, count, ctx);
+        return;
+    }
+    threadPool().parallelFor(
+        0, count,
+        [&](size_t from, size_t to) {
+            mulMod(a + from, b + from, out + from, to - from, ctx);
+        },
+        grain);
+}
+
+// out[i] = a[i] * b[i] in the field. Large batches are split between the
+// threads of the pool.
+void mulMod(const vector<uint64_t>& a, const vector<uint64_t>& b,
+            vector<uint64_t>& out, const FieldContext& ctx) {
+    size_t count = min(a.size(), b.size());
+    out.resize(count);
+    mulModParallel(a.data(), b.data(), out.data(), count, ctx);
+}
+
+// sum of a[i] * b[i] in the field. The products are XORed unreduced into
+// independent accumulators, eight products per iteration with VPCLMULQDQ or
+// four chains otherwise, and the total is reduced once.
+uint64_t dot(const vector<uint64_t>& a, const vector<uint64_t>& b,
+             const FieldContext& ctx) {
+    size_t count = min(a.size(), b.size());
+    size_t i = 0;
+    unsigned __int128 acc[4] = {};
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__VPCLMULQDQ__)
+    __m512i even = _mm512_setzero_si512();
+    __m512i odd = _mm512_setzero_si512();
+    for (; i + 8 <= count; i += 8) {
+        __m512i va = _mm512_loadu_si512(a.data() + i);
+        __m512i vb = _mm512_loadu_si512(b.data() + i);
+        even = _mm512_xor_si512(even, _mm512_clmulepi64_epi128(va, vb, 0x00));
+        odd = _mm512_xor_si512(odd, _mm512_clmulepi64_epi128(va, vb, 0x11));
+    }
+    uint64_t lanes[8];
+    _mm512_storeu_si512(lanes, _mm512_xor_si512(even, odd));
+    for (int j = 0; j < 4; j++) {
+        acc[j] = ((unsigned __int128)lanes[2 * j + 1] << 64) | lanes[2 * j];
+    }
+#endif
+
+    for (; i + 4 <= count; i += 4) {
+        for (int j = 0; j < 4; j++) {
+            acc[j] ^= clmul(a[i + j], b[i + j]);
+        }
+    }
+    for (; i < count; i++) {
+        acc[0] ^= clmul(a[i], b[i]);
+    }
+    return reduce(acc[0] ^ acc[1] ^ acc[2] ^ acc[3], ctx);
+}
+
+// The polynomial with coeffs[i] the coefficient of x^i, evaluated at x.
+// Horner's rule is one chain of dependent multiplications, so it is split
+// into four: p(x) = sum over j < 4 of x^j p_j(x^4), where p_j takes every
+// fourth coefficient from j on. The chains run side by side and are
+// combined with a single reduction.
+uint64_t hornerEval(const vector<uint64_t>& coeffs, uint64_t x,
+                    const FieldContext& ctx) {
+    uint64_t x2 = mulMod(x, x, ctx);
+    uint64_t x3 = mulMod(x2, x, ctx);
+    uint64_t x4 = mulMod(x2, x2, ctx);
+
+    uint64_t acc[4] = {};
+    size_t count = coeffs.size();
+    for (size_t step = (count + 3) / 4; step-- > 0;) {
+        for (size_t j = 0; j < 4; j++) {
+            size_t i = 4 * step + j;
+            uint64_t c = i < count ? coeffs[i] : 0;
+            acc[j] = reduce(clmul(acc[j], x4) ^ c, ctx);
+        }
+    }
+    return (lazy(acc[0]) + lazy(x) * lazy(acc[1]) + lazy(x2) * lazy(acc[2]) +
+            lazy(x3) * lazy(acc[3])) %
+           ctx;
+}
+
+// The polynomial evaluated at every point, e.g. the syndromes of a received
+// word. Several points share each pass over the coefficients, which keeps
+// that many independent Horner chains in flight: eight in two vectors with
+// VPCLMULQDQ, four otherwise.
+vector<uint64_t> hornerEval(const vector<uint64_t>& coeffs,
+                            const vector<uint64_t>& points,
+                            const FieldContext& ctx) {
+    vector<uint64_t> res(points.size());
+    size_t i = 0;
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__VPCLMULQDQ__)
+    // One point in the low qword of every 128-bit lane.
+    const __mmask8 low = 0x55;
+    for (; i + 8 <= points.size(); i += 8) {
+        __m512i x0 = _mm512_maskz_expandloadu_epi64(low, points.data() + i);
+        __m512i x1 =
+            _mm512_maskz_expandloadu_epi64(low, points.data() + i + 4);
+        __m512i acc0 = _mm512_setzero_si512();
+        __m512i acc1 = _mm512_setzero_si512();
+        for (size_t k = coeffs.size(); k-- > 0;) {
+            __m512i c = _mm512_maskz_set1_epi64(low, coeffs[k]);
+            acc0 = reduceLanes(
+                _mm512_xor_si512(_mm512_clmulepi64_epi128(acc0, x0, 0x00), c),
+                ctx);
+            acc1 = reduceLanes(
+                _mm512_xor_si512(_mm512_clmulepi64_epi128(acc1, x1, 0x00), c),
+                ctx);
+        }
+        _mm512_mask_compressstoreu_epi64(res.data() + i, low, acc0);
+        _mm512_mask_compressstoreu_epi64(res.data() + i + 4, low, acc1);
+    }
+#endif
+
+    for (; i + 4 <= points.size(); i += 4) {
+        uint64_t acc[4] = {};
+        for (size_t k = coeffs.size(); k-- > 0;) {
+            for (size_t j = 0; j < 4; j++) {
+                acc[j] = reduce(clmul(acc[j], points[i + j]) ^ coeffs[k], ctx);
+            }
+        }
+        copy(acc, acc + 4, res.begin() + i);
+    }
+    for (; i < points.size(); i++) {
+        res[i] = hornerEval(coeffs, points[i], ctx);
+    }
+    return res;
+}
+
+// Multiplication by one fixed element b with precomputed tables, for when
+// the same b is used many times. For every window of w bits of the other
+// operand (w = 4 or 8) there is a table of u * x^(w * i) * b mod p over all
+// w-bit u, so a product is one lookup per window and XORs, with no
+// carry-less multiply and no reduction. This is the comb method with the
+// reduction moved into the tables; it pays off where clmul is done in
+// software. In constant-time mode every entry of a table is read and the
+// wanted one kept by a mask, so the memory accesses do not depend on a.
+struct FixedMultiplier {
+    int window;
+    int windows;
+    bool constantTime;
+    // tables[(i << window) + u] = u * x^(window * i) * b mod p
+    vector<uint64_t> tables;
+};
+
+FixedMultiplier makeFixedMultiplier(uint64_t b, const FieldContext& ctx,
+                                    int window = 4) {
+    FixedMultiplier m;
+    m.window = window;
+    m.windows = (ctx.deg + window - 1) / window;
+    m.constantTime = ctx.constantTime;
+    m.tables.assign((size_t)m.windows << window, 0);
+
+    uint64_t shifted = b;
+    for (int i = 0; i < m.windows; i++) {
+        uint64_t* table = m.tables.data() + ((size_t)i << window);
+        for (int k = 0; k < window; k++) {
+            table[1 << k] = shifted;
+            shifted = mulMod(shifted, 2, ctx);
+        }
+        for (int u = 3; u < (1 << window); u++) {
+            table[u] = table[u & (u - 1)] ^ table[u & -u];
+        }
+    }
+    return m;
+}
+
+uint64_t multiply(const FixedMultiplier& m, uint64_t a) {
+    uint64_t mask = (1ULL << m.window) - 1;
+    uint64_t res = 0;
+    for (int i = 0; i < m.windows; i++) {
+        const uint64_t* table = m.tables.data() + ((size_t)i << m.window);
+        uint64_t u = (a >> (m.window * i)) & mask;
+        if (!m.constantTime) {
+            res ^= table[u];
+            continue;
+        }
+        for (uint64_t v = 0; v <= mask; v++) {
+            res ^= table[v] & (0 - (uint64_t)(v == u));
+        }
+    }
+    return res;
+}
+
+// Bit matrices are stored one row per word: bit j of row i is entry (i, j).
+// For 8x8 matrices the rows are the bytes of a uint64_t.
+
+uint64_t transpose8x8(uint64_t m) {
+    uint64_t t = (m ^ (m >> 7)) & 0x00AA00AA00AA00AAULL;
+    m ^= t ^ (t << 7);
+    t = (m ^ (m >> 14)) & 0x0000CCCC0000CCCCULL;
+    m ^= t ^ (t << 14);
+    t = (m ^ (m >> 28)) & 0x00000000F0F0F0F0ULL;
+    m ^= t ^ (t << 28);
+    return m;
+}
+
+// Transposes count 8x8 matrices. GF2P8AFFINEQB multiplies the bytes of its
+// first operand by the 8x8 matrix in the second with the rows in reverse
+// order, so applied to the identity it transposes a byte-reversed matrix;
+// eight matrices go through one instruction.
+void transpose8x8(const uint64_t* in, uint64_t* out, size_t count) {
+    size_t i = 0;
+#if defined(__GFNI__) && defined(__AVX512F__) && defined(__AVX512BW__)
+    const __m512i identity = _mm512_set1_epi64(0x8040201008040201ULL);
+    const __m512i reverseBytes = _mm512_set4_epi32(
+        0x08090A0B, 0x0C0D0E0F, 0x00010203, 0x04050607);
+    for (; i + 8 <= count; i += 8) {
+        __m512i m =
+            _mm512_shuffle_epi8(_mm512_loadu_si512(in + i), reverseBytes);
+        _mm512_storeu_si512(out + i,
+                            _mm512_gf2p8affine_epi64_epi8(identity, m, 0));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = transpose8x8(in[i]);
+    }
+}
+
+// In-place 64x64 transpose by recursive block swaps: the off-diagonal
+// 32x32 blocks are exchanged, then the 16x16 blocks inside every quadrant,
+// and so on down to single bits, each level with masked shifts of whole rows.
+void transpose64x64(uint64_t* rows) {
+    uint64_t mask = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        int k = 0;
+#ifdef __AVX2__
+        // Four consecutive rows have bit j clear together when j >= 4.
+        __m256i vmask = _mm256_set1_epi64x(mask);
+        __m128i shift = _mm_cvtsi32_si128(j);
+        for (; j >= 4 && k < 64; k = (k + j + 4) & ~j) {
+            __m256i low = _mm256_loadu_si256((__m256i*)(rows + k));
+            __m256i high = _mm256_loadu_si256((__m256i*)(rows + k + j));
+            __m256i t = _mm256_and_si256(
+                _mm256_xor_si256(_mm256_srl_epi64(low, shift), high), vmask);
+            _mm256_storeu_si256((__m256i*)(rows + k + j),
+                                _mm256_xor_si256(high, t));
+            _mm256_storeu_si256(
+                (__m256i*)(rows + k),
+                _mm256_xor_si256(low, _mm256_sll_epi64(t, shift)));
+        }
+#endif
+        for (; k < 64; k = (k + j + 1) & ~j) {
+            uint64_t t = ((rows[k] >> j) ^ rows[k + j]) & mask;
+            rows[k + j] ^= t;
+            rows[k] ^= t << j;
+        }
+    }
+}
+
+// Transpose of a rows x cols bit matrix with each row padded to whole words,
+// done as 64x64 blocks.
+vector<uint64_t> transposeBitMatrix(const vector<uint64_t>& m, int rows,
+                                    int cols) {
+    int inWords = (cols + WORD_BITS - 1) / WORD_BITS;
+    int outWords = (rows + WORD_BITS - 1) / WORD_BITS;
+    vector<uint64_t> res((size_t)cols * outWords);
+
+    uint64_t block[WORD_BITS];
+    for (int r = 0; r < outWords; r++) {
+        for (int c = 0; c < inWords; c++) {
+            for (int i = 0; i < WORD_BITS; i++) {
+                int row = r * WORD_BITS + i;
+                block[i] = row < rows ? m[(size_t)row * inWords + c] : 0;
+            }
+            transpose64x64(block);
+            for (int i = 0; i < WORD_BITS && c * WORD_BITS + i < cols; i++) {
+                res[(size_t)(c * WORD_BITS + i) * outWords + r] = block[i];
+            }
+        }
+    }
+    return res;
+}
+
+// Chien search: the positions 0 <= i < n with locator(alpha^i) = 0, in
+// increasing order, where alpha = x generates the multiplicative group when
+// p is primitive and locator[j] is the coefficient of x^j. n defaults to
+// 2^q - 1. The search stops once deg(locator) roots are found.
+//
+// Term j takes the values locator[j] * alpha^(j i) for consecutive i. The
+// terms are held bitsliced for 64 positions at once, one word per
+// coefficient bit, so a sum over the terms is q XORs of words and a zero
+// sum shows as a zero bit in all q words. Moving 64 positions on multiplies
+// term j by the constant alpha^(64 j), a fixed linear map of the q words.
+vector<uint64_t> chienSearch(const vector<uint64_t>& locator,
+                             const FieldContext& ctx, uint64_t n = 0) {
+    int q = ctx.deg;
+    if (n == 0) {
+        n = ctx.mask;
+    }
+    int deg = (int)locator.size() - 1;
+    while (deg >= 0 && locator[deg] == 0) {
+        deg--;
+    }
+    if (deg <= 0) {
+        return {};
+    }
+
+    // Multiplying by alpha = x is a shift, so the tables need no products.
+    auto timesX = [&](uint64_t a) {
+        return (a << 1) ^ (ctx.modulus & (0 - ((a >> (q - 1)) & 1)));
+    };
+
+    // terms[j * q + b] holds bit b of term j for the next 64 positions.
+    // Bit b of alpha^(64 j) * x^k, the step of term j, is expanded to all
+    // zeros or all ones in steps[(j * q + k) * stride + b]; the rows are
+    // padded to whole vectors.
+    int stride = (q + 7) / 8 * 8;
+    vector<uint64_t> terms((deg + 1) * q);
+    vector<uint64_t> steps((size_t)(deg + 1) * q * stride);
+    uint64_t alphaJ = 1, stepJ = 1;
+    uint64_t values[WORD_BITS];
+    for (int j = 0; j <= deg; j++) {
+        // The first 64 values of the term, transposed into bit slices
+        values[0] = locator[j];
+        for (int k = 1; k < WORD_BITS; k++) {
+#ifdef __PCLMUL__
+            values[k] = mulMod(values[k - 1], alphaJ, ctx);
+#else
+            values[k] = values[k - 1];
+            for (int s = 0; s < j; s++) {
+                values[k] = timesX(values[k]);
+            }
+#endif
+        }
+        transpose64x64(values);
+        copy(values, values + q, terms.begin() + j * q);
+        alphaJ = timesX(alphaJ);
+
+        uint64_t column = stepJ;
+        for (int k = 0; k < q; k++) {
+            for (int b = 0; b < q; b++) {
+                steps[(j * q + k) * stride + b] = 0 - ((column >> b) & 1);
+            }
+            column = timesX(column);
+        }
+        for (int s = 0; s < WORD_BITS; s++) {
+            stepJ = timesX(stepJ);
+        }
+    }
+
+    vector<uint64_t> roots;
+    uint64_t sum[WORD_BITS], product[WORD_BITS];
+    for (uint64_t base = 0; base < n && (int)roots.size() < deg;
+         base += WORD_BITS) {
+        fill(sum, sum + q, 0);
+        for (int j = 0; j <= deg; j++) {
+            for (int b = 0; b < q; b++) {
+                sum[b] ^= terms[j * q + b];
+            }
+        }
+        uint64_t nonzero = 0;
+        for (int b = 0; b < q; b++) {
+            nonzero |= sum[b];
+        }
+        uint64_t zero = ~nonzero;
+        if (n - base < (uint64_t)WORD_BITS) {
+            zero &= (1ULL << (n - base)) - 1;
+        }
+        for (; zero != 0 && (int)roots.size() < deg; zero &= zero - 1) {
+            roots.push_back(base + __builtin_ctzll(zero));
+        }
+
+        // Term 0 is constant.
+        for (int j = 1; j <= deg; j++) {
+            const uint64_t* rows = &steps[(size_t)j * q * stride];
+#ifdef __AVX512F__
+            for (int c = 0; c < stride; c += 8) {
+                __m512i acc = _mm512_setzero_si512();
+                for (int k = 0; k < q; k++) {
+                    acc = _mm512_xor_si512(
+                        acc, _mm512_and_si512(
+                                 _mm512_set1_epi64(terms[j * q + k]),
+                                 _mm512_loadu_si512(rows + k * stride + c)));
+                }
+                _mm512_storeu_si512(product + c, acc);
+            }
+#else
+            fill(product, product + q, 0);
+            for (int k = 0; k < q; k++) {
+                uint64_t slice = terms[j * q + k];
+                for (int b = 0; b < q; b++) {
+                    product[b] ^= slice & rows[k * stride + b];
+                }
+            }
+#endif
+            copy(product, product + q, terms.begin() + j * q);
+        }
+    }
+    return roots;
+}
+
+// 64 elements of GF(2^q), q <= 8, stored bitsliced: bit i of slices[j] is the
+// coefficient of x^j in element i. Arithmetic on a batch is a fixed network
+// of ANDs and XORs over whole words, with no tables and no branches on the
+// data, so it also runs in constant time.
+struct BitslicedBatch {
+    uint64_t slices[8];
+};
+
+// The circuits for one modulus p of degree q. A product is formed as
+// schoolbook partial products, then every x^k with k >= q is folded onto the
+// bits of x^k mod p. Squaring is linear and folds x^(2j) mod p directly.
+struct BitslicedCircuit {
+    int deg;
+    // reduction[k - q] = x^k mod p, for q <= k <= 2q - 2
+    uint8_t reduction[8];
+    // squares[j] = x^(2j) mod p
+    uint8_t squares[8];
+};
+
+// The batches hold 8 slices, so p must have degree 1 to 8; otherwise the
+// circuit has deg = 0, which mulBitsliced and invertBitsliced refuse.
+BitslicedCircuit makeBitslicedCircuit(const Polynomial& p) {
+    BitslicedCircuit circuit = {};
+    circuit.deg = degree(p);
+    if (circuit.deg < 1 || circuit.deg > 8) {
+        circuit.deg = 0;
+        return circuit;
+    }
+    FieldContext ctx = makeFieldContext(p);
+    for (int k = 0; k < circuit.deg; k++) {
+        circuit.reduction[k] =
+            mulMod(1ULL << (circuit.deg - 1), 1ULL << (k + 1), ctx);
+        circuit.squares[k] = mulMod(1ULL << k, 1ULL << k, ctx);
+    }
+    return circuit;
+}
+
+// Each group of 8 elements is an 8x8 bit matrix; after transposing it, byte
+// j holds coefficient j of the group and goes into slice j. The batch is
+// zero unless 1 <= deg <= 8.
+BitslicedBatch toBitsliced(const uint8_t* elements, int deg) {
+    BitslicedBatch batch = {};
+    if (deg < 1 || deg > 8) {
+        return batch;
+    }
+    uint64_t groups[8], transposed[8];
+    memcpy(groups, elements, sizeof(groups));
+    transpose8x8(groups, transposed, 8);
+
+    for (int j = 0; j < deg; j++) {
+        for (int i = 0; i < 8; i++) {
+            batch.slices[j] |= ((transposed[i] >> (8 * j)) & 0xFF) << (8 * i);
+        }
+    }
+    return batch;
+}
+
+// The elements are zero unless 1 <= deg <= 8.
+void fromBitsliced(const BitslicedBatch& batch, uint8_t* elements, int deg) {
+    uint64_t groups[8], transposed[8] = {};
+    for (int j = 0; j < deg && deg <= 8; j++) {
+        for (int i = 0; i < 8; i++) {
+            transposed[i] |= ((batch.slices[j] >> (8 * i)) & 0xFF) << (8 * j);
+        }
+    }
+
+    transpose8x8(transposed, groups, 8);
+    memcpy(elements, groups, sizeof(groups));
+}
+
+BitslicedBatch multiply(const BitslicedBatch& a, const BitslicedBatch& b,
+                        const BitslicedCircuit& circuit) {
+    int deg = circuit.deg;
+    uint64_t product[15] = {};
+    for (int i = 0; i < deg; i++) {
+        for (int j = 0; j < deg; j++) {
+            product[i + j] ^= a.slices[i] & b.slices[j];
+        }
+    }
+
+    BitslicedBatch res = {};
+    for (int k = 2 * deg - 2; k >= deg; k--) {
+        for (int t = 0; t < deg; t++) {
+            if ((circuit.reduction[k - deg] >> t) & 1) {
+                product[t] ^= product[k];
+            }
+        }
+    }
+    copy(product, product + deg, res.slices);
+    return res;
+}
+
+BitslicedBatch square(const BitslicedBatch& a,
+                      const BitslicedCircuit& circuit) {
+    BitslicedBatch res = {};
+    for (int j = 0; j < circuit.deg; j++) {
+        for (int t = 0; t < circuit.deg; t++) {
+            if ((circuit.squares[j] >> t) & 1) {
+                res.slices[t] ^= a.slices[j];
+            }
+        }
+    }
+    return res;
+}
+
+// a^(2^q - 2) = a^2 * a^4 * ... * a^(2^(q-1)), the inverse of every nonzero
+// element; zero maps to zero.
+BitslicedBatch inverse(const BitslicedBatch& a,
+                       const BitslicedCircuit& circuit) {
+    BitslicedBatch power = square(a, circuit);
+    BitslicedBatch res = power;
+    for (int i = 2; i < circuit.deg; i++) {
+        power = square(power, circuit);
+        res = multiply(res, power, circuit);
+    }
+    return res;
+}
+
+// out[i] = a[i] * b[i] in GF(2^q), 64 elements per bitsliced batch.
+// Returns false, with out empty, for a circuit of deg 0.
+bool mulBitsliced(const vector<uint8_t>& a, const vector<uint8_t>& b,
+                  vector<uint8_t>& out, const BitslicedCircuit& circuit) {
+    if (circuit.deg == 0) {
+        out.clear();
+        return false;
+    }
+    size_t count = min(a.size(), b.size());
+    out.resize(count);
+    uint8_t blockA[WORD_BITS], blockB[WORD_BITS], blockOut[WORD_BITS];
+    for (size_t i = 0; i < count; i += WORD_BITS) {
+        size_t len = min<size_t>(WORD_BITS, count - i);
+        fill(blockA, blockA + WORD_BITS, 0);
+        fill(blockB, blockB + WORD_BITS, 0);
+        copy(a.begin() + i, a.begin() + i + len, blockA);
+        copy(b.begin() + i, b.begin() + i + len, blockB);
+
+        BitslicedBatch product =
+            multiply(toBitsliced(blockA, circuit.deg),
+                     toBitsliced(blockB, circuit.deg), circuit);
+        fromBitsliced(product, blockOut, circuit.deg);
+        copy(blockOut, blockOut + len, out.begin() + i);
+    }
+    return true;
+}
+
+// out[i] = a[i]^-1 in GF(2^q), with 0 mapped to 0. Returns false, with
+// out empty, for a circuit of deg 0.
+bool invertBitsliced(const vector<uint8_t>& a, vector<uint8_t>& out,
+                     const BitslicedCircuit& circuit) {
+    if (circuit.deg == 0) {
+        out.clear();
+        return false;
+    }
+    out.resize(a.size());
+    uint8_t block[WORD_BITS];
+    for (size_t i = 0; i < a.size(); i += WORD_BITS) {
+        size_t len = min<size_t>(WORD_BITS, a.size() - i);
+        fill(block, block + WORD_BITS, 0);
+        copy(a.begin() + i, a.begin() + i + len, block);
+
+        fromBitsliced(inverse(toBitsliced(block, circuit.deg), circuit), block,
+                      circuit.deg);
+        copy(block, block + len, out.begin() + i);
+    }
+    return true;
+}
+
+// Multiplication of byte regions by a constant c of GF(2^8). c * u is
+// linear in u, so it is the XOR of c times the low nibble and c times the
+// high nibble, and each of those comes from a 16-entry table. With SSSE3
+// the tables sit in a register and PSHUFB looks up 16 bytes at once, with
+// AVX-512BW 64.
+struct NibbleTables {
+    // low[u] = c * u and high[u] = c * (u << 4)
+    uint8_t low[16];
+    uint8_t high[16];
+};
+
+NibbleTables makeNibbleTables(uint8_t c, const FieldContext& ctx) {
+    NibbleTables t;
+    for (int u = 0; u < 16; u++) {
+        t.low[u] = mulMod(c, u, ctx);
+        t.high[u] = mulMod(c, u << 4, ctx);
+    }
+    return t;
+}
+
+// dst[i] ^= c * src[i] for i < count
+void mulAddRegion(uint8_t* dst, const uint8_t* src, size_t count,
+                  const NibbleTables& t) {
+    size_t i = 0;
+#if defined(__AVX512BW__)
+    // The zero-masking broadcast, with all lanes kept, avoids a spurious
+    // GCC 12 warning about the undefined source of the plain one.
+    const __m512i low = _mm512_maskz_broadcast_i32x4(
+        0xFFFF, _mm_loadu_si128((const __m128i*)t.low));
+    const __m512i high = _mm512_maskz_broadcast_i32x4(
+        0xFFFF, _mm_loadu_si128((const __m128i*)t.high));
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    for (; i + 64 <= count; i += 64) {
+        __m512i s = _mm512_loadu_si512(src + i);
+        __m512i product = _mm512_xor_si512(
+            _mm512_shuffle_epi8(low, _mm512_and_si512(s, nibble)),
+            _mm512_shuffle_epi8(
+                high, _mm512_and_si512(_mm512_srli_epi16(s, 4), nibble)));
+        _mm512_storeu_si512(
+            dst + i, _mm512_xor_si512(_mm512_loadu_si512(dst + i), product));
+    }
+#elif defined(__SSSE3__)
+    const __m128i low = _mm_loadu_si128((const __m128i*)t.low);
+    const __m128i high = _mm_loadu_si128((const __m128i*)t.high);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    for (; i + 16 <= count; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i product = _mm_xor_si128(
+            _mm_shuffle_epi8(low, _mm_and_si128(s, nibble)),
+            _mm_shuffle_epi8(high,
+                             _mm_and_si128(_mm_srli_epi16(s, 4), nibble)));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, product));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] ^= t.low[src[i] & 0x0F] ^ t.high[src[i] >> 4];
+    }
+}
+
+// Shamir secret sharing over GF(2^8), byte by byte: byte i of the secret is
+// f_i(0) for a random polynomial f_i of degree below k, and the share with
+// coordinate x holds f_i(x) for every i. Any k shares determine the secret
+// and fewer reveal nothing about it.
+struct Share {
+    uint8_t x;
+    vector<uint8_t> data;
+};
+
+// n shares with threshold k, at coordinates 1..n. Coefficient j of all the
+// f_i together is a region of random bytes, so share x is the secret plus
+// x^j times region j summed over j, k - 1 region passes per share. Empty if
+// the parameters are invalid (ctx not an irreducible modulus of degree 8,
+// k < 1, k > n, n > 255) or /dev/urandom cannot be read.
+vector<Share> splitSecret(const vector<uint8_t>& secret, int n, int k,
+                          const FieldContext& ctx) {
+    if (ctx.deg != 8 || !isIrreducible(ctx) || k < 1 || k > n || n > 255) {
+        return {};
+    }
+
+    size_t size = secret.size();
+    vector<uint8_t> coefficients((size_t)(k - 1) * size);
+    ifstream random("/dev/urandom", ios::binary);
+    if (!random.read((char*)coefficients.data(), coefficients.size())) {
+        return {};
+    }
+
+    vector<Share> shares(n);
+    vector<NibbleTables> tables;
+    for (int s = 0; s < n; s++) {
+        shares[s].x = s + 1;
+        shares[s].data.resize(size);
+        uint64_t power = 1;
+        for (int j = 1; j < k; j++) {
+            power = mulMod(power, shares[s].x, ctx);
+            tables.push_back(makeNibbleTables(power, ctx));
+        }
+    }
+
+    // Every range of bytes goes through all shares while it is in cache.
+    threadPool().parallelFor(
+        0, size,
+        [&](size_t from, size_t to) {
+            for (int s = 0; s < n; s++) {
+                uint8_t* out = shares[s].data.data() + from;
+                copy(secret.begin() + from, secret.begin() + to, out);
+                for (int j = 1; j < k; j++) {
+                    mulAddRegion(out,
+                                 coefficients.data() + (j - 1) * size + from,
+                                 to - from, tables[s * (k - 1) + j - 1]);
+                }
+            }
+        },
+        1 << 16);
+    return shares;
+}
+
+// The secret from at least k shares, as sum over shares s of
+// data_s * prod over t != s of x_t / (x_t + x_s), the Lagrange coefficients
+// at 0. Empty if there are no shares, a coordinate is 0 or repeated, the
+// shares differ in length or ctx is not an irreducible modulus of degree 8.
+vector<uint8_t> combineShares(const vector<Share>& shares,
+                              const FieldContext& ctx) {
+    if (ctx.deg != 8 || !isIrreducible(ctx) || shares.empty()) {
+        return {};
+    }
+    size_t size = shares[0].data.size();
+    vector<NibbleTables> tables;
+    for (const Share& s : shares) {
+        uint64_t numerator = 1, denominator = 1;
+        for (const Share& t : shares) {
+            if (&t == &s) {
+                continue;
+            }
+            if (t.x == s.x) {
+                return {};
+            }
+            numerator = mulMod(numerator, t.x, ctx);
+            denominator = mulMod(denominator, t.x ^ s.x, ctx);
+        }
+        if (s.x == 0 || s.data.size() != size) {
+            return {};
+        }
+        tables.push_back(makeNibbleTables(
+            mulMod(numerator, inverse(denominator, ctx), ctx), ctx));
+    }
+
+    vector<uint8_t> secret(size);
+    threadPool().parallelFor(
+        0, size,
+        [&](size_t from, size_t to) {
+            for (size_t s = 0; s < shares.size(); s++) {
+                mulAddRegion(secret.data() + from,
+                             shares[s].data.data() + from, to - from,
+                             tables[s]);
+            }
+        },
+        1 << 16);
+    return secret;
+}
+
+// dst ^= src, a word or a vector at a time
+void xorRegion(uint8_t* dst, const uint8_t* src, size_t count) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i + 64 <= count; i += 64) {
+        _mm512_storeu_si512(dst + i,
+                            _mm512_xor_si512(_mm512_loadu_si512(dst + i),
+                                             _mm512_loadu_si512(src + i)));
+    }
+#elif defined(__AVX2__)
+    for (; i + 32 <= count; i += 32) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, s));
+    }
+#endif
+    for (; i + 8 <= count; i += 8) {
+        uint64_t d, s;
+        memcpy(&d, dst + i, 8);
+        memcpy(&s, src + i, 8);
+        d ^= s;
+        memcpy(dst + i, &d, 8);
+    }
+    for (; i < count; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+// Inverse of the n x n matrix a over the field, row-major, by Gauss-Jordan
+// elimination. Empty if a is singular.
+vector<uint64_t> invertMatrix(vector<uint64_t> a, int n,
+                              const FieldContext& ctx) {
+    vector<uint64_t> res(n * n);
+    for (int i = 0; i < n; i++) {
+        res[i * n + i] = 1;
+    }
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        while (pivot < n && a[pivot * n + col] == 0) {
+            pivot++;
+        }
+        if (pivot == n) {
+            return {};
+        }
+        for (int j = 0; j < n; j++) {
+            swap(a[col * n + j], a[pivot * n + j]);
+            swap(res[col * n + j], res[pivot * n + j]);
+        }
+
+        uint64_t scale = inverse(a[col * n + col], ctx);
+        for (int j = 0; j < n; j++) {
+            a[col * n + j] = mulMod(a[col * n + j], scale, ctx);
+            res[col * n + j] = mulMod(res[col * n + j], scale, ctx);
+        }
+        for (int i = 0; i < n; i++) {
+            uint64_t factor = a[i * n + col];
+            if (i == col || factor == 0) {
+                continue;
+            }
+            for (int j = 0; j < n; j++) {
+                a[i * n + j] ^= mulMod(factor, a[col * n + j], ctx);
+                res[i * n + j] ^= mulMod(factor, res[col * n + j], ctx);
+            }
+        }
+    }
+    return res;
+}
+
+// Cauchy Reed-Solomon as XORs only. Each element e of GF(2^w) acts on the
+// field as the w x w bit matrix whose column c is e * x^c, so a block split
+// into w packets is multiplied by e by XORing packets. A coding matrix over
+// the field thus becomes a bit matrix, and its ones count the XORs.
+
+// The number of ones in the w x w bit matrix of e.
+int bitmatrixOnes(uint64_t e, const FieldContext& ctx) {
+    int count = 0;
+    for (int c = 0; c < ctx.deg; c++) {
+        count += __builtin_popcountll(e);
+        e = mulMod(e, 2, ctx);
+    }
+    return count;
+}
+
+// bitmatrixOnes of every element, for fields of degree up to 16, so a
+// search over the points can score a matrix with lookups; empty otherwise.
+vector<int> bitmatrixOnesTable(const FieldContext& ctx) {
+    vector<int> res;
+    if (ctx.deg <= 16) {
+        for (uint64_t e = 0; e <= ctx.mask; e++) {
+            res.push_back(bitmatrixOnes(e, ctx));
+        }
+    }
+    return res;
+}
+
+// The m x k Cauchy matrix 1 / (xs[i] + ys[j]) for distinct points xs and
+// ys, with rows and columns scaled towards few ones: every column is
+// divided by its entry in row 0, which makes that row all ones (identity
+// blocks), and every other row by whichever of its entries leaves the
+// fewest ones. Any square submatrix stays invertible. ones is empty or
+// bitmatrixOnesTable(ctx).
+vector<uint64_t> cauchyMatrix(const vector<uint64_t>& xs,
+                              const vector<uint64_t>& ys,
+                              const FieldContext& ctx,
+                              const vector<int>& ones = {}) {
+    int m = xs.size(), k = ys.size();
+    vector<uint64_t> res(m * k);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < k; j++) {
+            res[i * k + j] = inverse(xs[i] ^ ys[j], ctx);
+        }
+    }
+
+    auto weight = [&](uint64_t e) {
+        return ones.empty() ? bitmatrixOnes(e, ctx) : ones[e];
+    };
+
+    for (int j = 0; j < k; j++) {
+        uint64_t scale = inverse(res[j], ctx);
+        for (int i = 0; i < m; i++) {
+            res[i * k + j] = mulMod(res[i * k + j], scale, ctx);
+        }
+    }
+    for (int i = 1; i < m; i++) {
+        int best = INT32_MAX;
+        uint64_t bestScale = 1;
+        for (int j = 0; j < k; j++) {
+            uint64_t scale = inverse(res[i * k + j], ctx);
+            int count = 0;
+            for (int t = 0; t < k; t++) {
+                count += weight(mulMod(res[i * k + t], scale, ctx));
+            }
+            if (count < best) {
+                best = count;
+                bestScale = scale;
+            }
+        }
+        for (int j = 0; j < k; j++) {
+            res[i * k + j] = mulMod(res[i * k + j], bestScale, ctx);
+        }
+    }
+    return res;
+}
+
+// The scaled Cauchy matrix for k data and m coding blocks. It starts from
+// x_i = i and y_j = m + j; when k + m < 2^w, for w <= 16, the points are
+// then searched: each in turn is swapped for the unused field element that
+// most lowers the ones of the bit matrix, until no swap helps. The result
+// thus never has more ones than the fixed points give. Needs k + m <= 2^w.
+vector<uint64_t> cauchyMatrix(int k, int m, const FieldContext& ctx) {
+    vector<uint64_t> points(k + m);
+    for (int t = 0; t < k + m; t++) {
+        points[t] = t;
+    }
+    vector<int> ones = bitmatrixOnesTable(ctx);
+    auto build = [&]() {
+        return cauchyMatrix(
+            vector<uint64_t>(points.begin(), points.begin() + m),
+            vector<uint64_t>(points.begin() + m, points.end()), ctx, ones);
+    };
+    auto score = [&](const vector<uint64_t>& matrix) {
+        int count = 0;
+        for (uint64_t e : matrix) {
+            count += ones[e];
+        }
+        return count;
+    };
+
+    vector<uint64_t> res = build();
+    if (ones.empty() || (uint64_t)k + m > ctx.mask) {
+        return res;
+    }
+    vector<bool> used(ctx.mask + 1);
+    for (uint64_t p : points) {
+        used[p] = true;
+    }
+    int best = score(res);
+    for (bool improved = true; improved;) {
+        improved = false;
+        for (int t = 0; t < k + m; t++) {
+            uint64_t current = points[t], bestPoint = current;
+            for (uint64_t e = 0; e <= ctx.mask; e++) {
+                if (used[e]) {
+                    continue;
+                }
+                points[t] = e;
+                vector<uint64_t> candidate = build();
+                int count = score(candidate);
+                if (count < best) {
+                    best = count;
+                    bestPoint = e;
+                    res = move(candidate);
+                }
+            }
+            points[t] = bestPoint;
+            if (bestPoint != current) {
+                used[current] = false;
+                used[bestPoint] = true;
+                improved = true;
+            }
+        }
+    }
+    return res;
+}
+
+// The (rows * w) x (cols * w) bit matrix of a rows x cols matrix over the
+// field, one byte per bit, row-major.
+vector<uint8_t> toBitmatrix(const vector<uint64_t>& matrix, int rows,
+                            int cols, const FieldContext& ctx) {
+    int w = ctx.deg;
+    vector<uint8_t> res((size_t)rows * w * cols * w);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            uint64_t column = matrix[i * cols + j];
+            for (int c = 0; c < w; c++) {
+                for (int r = 0; r < w; r++) {
+                    res[((size_t)i * w + r) * cols * w + j * w + c] =
+                        (column >> r) & 1;
+                }
+                column = mulMod(column, 2, ctx);
+            }
+        }
+    }
+    return res;
+}
+
+// A straight-line program of packet XORs. Packets 0 to inputs - 1 are the
+// inputs, the next outputs packets the outputs and the rest temporaries.
+// A step sets dst to src, or to zero if src is -1, or XORs src into dst.
+struct XorStep {
+    int dst;
+    int src;
+    bool assign;
+};
+
+struct XorSchedule {
+    int inputs;
+    int outputs;
+    int temporaries;
+    vector<XorStep> steps;
+};
+
+// The schedule computing output r as the XOR of the inputs c with
+// bitmatrix[r * inputs + c] set. Common subexpressions are shared as in
+// Paar's heuristic: while some pair of signals appears together in two or
+// more outputs, the most frequent pair is computed once into a temporary
+// that replaces it everywhere.
+XorSchedule makeXorSchedule(const vector<uint8_t>& bitmatrix, int outputs,
+                            int inputs) {
+    vector<vector<int>> rows(outputs);
+    for (int r = 0; r < outputs; r++) {
+        for (int c = 0; c < inputs; c++) {
+            if (bitmatrix[(size_t)r * inputs + c]) {
+                rows[r].push_back(c);
+            }
+        }
+    }
+
+    // Signals are the inputs, then the temporaries.
+    auto packet = [&](int signal) {
+        return signal < inputs ? signal : signal + outputs;
+    };
+    XorSchedule res{inputs, outputs, 0, {}};
+    int signals = inputs;
+    vector<int> counts;
+    while (true) {
+        counts.assign((size_t)signals * signals, 0);
+        int best = 1, bestA = 0, bestB = 0;
+        for (const vector<int>& row : rows) {
+            for (size_t x = 0; x < row.size(); x++) {
+                for (size_t y = x + 1; y < row.size(); y++) {
+                    int& count = counts[(size_t)row[x] * signals + row[y]];
+                    count++;
+                    if (count > best) {
+                        best = count;
+                        bestA = row[x];
+                        bestB = row[y];
+                    }
+                }
+            }
+        }
+        if (best < 2) {
+            break;
+        }
+
+        res.temporaries++;
+        res.steps.push_back({packet(signals), packet(bestA), true});
+        res.steps.push_back({packet(signals), packet(bestB), false});
+        for (vector<int>& row : rows) {
+            auto a = find(row.begin(), row.end(), bestA);
+            auto b = find(row.begin(), row.end(), bestB);
+            if (a != row.end() && b != row.end()) {
+                row.erase(b);
+                row.erase(find(row.begin(), row.end(), bestA));
+                // Temporaries get the highest numbers, keeping rows sorted.
+                row.push_back(signals);
+            }
+        }
+        signals++;
+    }
+
+    for (int r = 0; r < outputs; r++) {
+        if (rows[r].empty()) {
+            res.steps.push_back({inputs + r, -1, true});
+        }
+        for (size_t x = 0; x < rows[r].size(); x++) {
+            res.steps.push_back({inputs + r, packet(rows[r][x]), x == 0});
+        }
+    }
+    return res;
+}
+
+// Runs the schedule on packets of size bytes. Packet p of the inputs is
+// inputs[p], and so on; temporaries come from the thread's arena. The
+// packets are processed a few KB at a time so that all of them stay in
+// cache.
+void runXorSchedule(const XorSchedule& schedule,
+                    const vector<const uint8_t*>& inputs,
+                    const vector<uint8_t*>& outputs, size_t size) {
+    const size_t chunk = 4096;
+    Arena& arena = threadArena();
+    ArenaScope scope(arena);
+    vector<uint8_t*> packets(schedule.inputs + schedule.outputs +
+                             schedule.temporaries);
+    vector<uint8_t*> temporaries(schedule.temporaries);
+    for (uint8_t*& t : temporaries) {
+        t = (uint8_t*)arena.allocate(chunk, 64);
+    }
+
+    for (size_t offset = 0; offset < size; offset += chunk) {
+        size_t len = min(chunk, size - offset);
+        for (int p = 0; p < schedule.inputs; p++) {
+            packets[p] = (uint8_t*)inputs[p] + offset;
+        }
+        for (int p = 0; p < schedule.outputs; p++) {
+            packets[schedule.inputs + p] = outputs[p] + offset;
+        }
+        copy(temporaries.begin(), temporaries.end(),
+             packets.begin() + schedule.inputs + schedule.outputs);
+
+        for (const XorStep& step : schedule.steps) {
+            uint8_t* dst = packets[step.dst];
+            if (step.src < 0) {
+                fill(dst, dst + len, 0);
+            } else if (step.assign) {
+                copy(packets[step.src], packets[step.src] + len, dst);
+            } else {
+                xorRegion(dst, packets[step.src], len);
+            }
+        }
+    }
+}
+
+// A systematic code with k data and m coding blocks over GF(2^w), where
+// coding block i is the sum over j of matrix[i * k + j] times data block j.
+struct CauchyCode {
+    int k;
+    int m;
+    FieldContext ctx;
+    vector<uint64_t> matrix;
+    XorSchedule encoder;
+};
+
+// The k + m points of the Cauchy matrix must be distinct elements of the
+// field, so k + m <= 2^w; the code has an empty matrix, which encode and
+// decode refuse, if that fails or k or m is below 1.
+CauchyCode makeCauchyCode(int k, int m, const FieldContext& ctx) {
+    if (k < 1 || m < 1 || (uint64_t)k + m > ctx.mask + 1) {
+        return {k, m, ctx, {}, {}};
+    }
+    CauchyCode code{k, m, ctx, cauchyMatrix(k, m, ctx), {}};
+    code.encoder =
+        makeXorSchedule(toBitmatrix(code.matrix, m, k, ctx), m * ctx.deg,
+                        k * ctx.deg);
+    return code;
+}
+
+// The w packets of each block, in order. blockSize must be a multiple of w.
+vector<uint8_t*> packetsOf(const vector<uint8_t*>& blocks, size_t blockSize,
+                           int w) {
+    vector<uint8_t*> res;
+    for (uint8_t* block : blocks) {
+        for (int c = 0; c < w; c++) {
+            res.push_back(block + c * (blockSize / w));
+        }
+    }
+    return res;
+}
+
+// Returns false if the code is invalid or blockSize is not a multiple of w.
+bool encode(const CauchyCode& code, const vector<uint8_t*>& data,
+            const vector<uint8_t*>& coding, size_t blockSize) {
+    int w = code.ctx.deg;
+    if (code.matrix.empty() || blockSize % w != 0) {
+        return false;
+    }
+    vector<uint8_t*> in = packetsOf(data, blockSize, w);
+    runXorSchedule(code.encoder, vector<const uint8_t*>(in.begin(), in.end()),
+                   packetsOf(coding, blockSize, w), blockSize / w);
+    return true;
+}
+
+// Rebuilds the erased blocks among blocks, the k data blocks followed by
+// the m coding blocks. The missing data blocks are the product of the
+// inverse of the rows of [I; matrix] for k surviving blocks with those
+// blocks, and missing coding blocks are encoded again. Returns false if
+// more than m blocks are erased, if blocks or erased do not hold k + m
+// entries, or for the cases encode refuses.
+bool decode(const CauchyCode& code, const vector<uint8_t*>& blocks,
+            const vector<bool>& erased, size_t blockSize) {
+    int k = code.k, w = code.ctx.deg;
+    size_t n = (size_t)k + code.m;
+    if (code.matrix.empty() || blockSize % w != 0 || blocks.size() != n ||
+        erased.size() != n) {
+        return false;
+    }
+    vector<int> survivors, lostData, lostCoding;
+    for (int b = 0; b < k + code.m; b++) {
+        if (!erased[b] && (int)survivors.size() < k) {
+            survivors.push_back(b);
+        }
+        if (erased[b]) {
+            (b < k ? lostData : lostCoding).push_back(b);
+        }
+    }
+    if ((int)survivors.size() < k) {
+        return false;
+    }
+
+    if (!lostData.empty()) {
+        vector<uint64_t> rows(k * k);
+        for (int i = 0; i < k; i++) {
+            int b = survivors[i];
+            for (int j = 0; j < k; j++) {
+                rows[i * k + j] = b < k ? (uint64_t)(b == j)
+                                        : code.matrix[(b - k) * k + j];
+            }
+        }
+        vector<uint64_t> inverted = invertMatrix(rows, k, code.ctx);
+        vector<uint64_t> decoder;
+        vector<uint8_t*> in, out;
+        for (int b : lostData) {
+            decoder.insert(decoder.end(), inverted.begin() + b * k,
+                           inverted.begin() + (b + 1) * k);
+            out.push_back(blocks[b]);
+        }
+        for (int b : survivors) {
+            in.push_back(blocks[b]);
+        }
+        XorSchedule schedule = makeXorSchedule(
+            toBitmatrix(decoder, lostData.size(), k, code.ctx),
+            lostData.size() * w, k * w);
+        in = packetsOf(in, blockSize, w);
+        runXorSchedule(schedule, vector<const uint8_t*>(in.begin(), in.end()),
+                       packetsOf(out, blockSize, w), blockSize / w);
+    }
+
+    if (!lostCoding.empty()) {
+        vector<uint64_t> rows;
+        vector<uint8_t*> out;
+        for (int b : lostCoding) {
+            rows.insert(rows.end(), code.matrix.begin() + (b - k) * k,
+                        code.matrix.begin() + (b - k + 1) * k);
+            out.push_back(blocks[b]);
+        }
+        XorSchedule schedule = makeXorSchedule(
+            toBitmatrix(rows, lostCoding.size(), k, code.ctx),
+            lostCoding.size() * w, k * w);
+        vector<uint8_t*> in = packetsOf(
+            vector<uint8_t*>(blocks.begin(), blocks.begin() + k), blockSize, w);
+        runXorSchedule(schedule, vector<const uint8_t*>(in.begin(), in.end()),
+                       packetsOf(out, blockSize, w), blockSize / w);
+    }
+    return true;
+}
+
+// Locally repairable codes: the k data blocks fall into groups that each
+// get an XOR parity, and a few global parities are Reed-Solomon-like sums
+// over GF(2^8) of all the data. A single lost block is rebuilt from its
+// group alone, so a repair reads the group size instead of k blocks, while
+// the global parities still cover multiple failures. Blocks are numbered
+// data first, then the local parities, then the global ones.
+struct LocalCode {
+    int k;
+    int groups;
+    int globals;
+    FieldContext ctx;
+    // global parity i = sum over j of coefficients[i * k + j] * data j
+    vector<uint64_t> coefficients;
+};
+
+// Global parity i uses coefficient a_j^(i + 1) for data block j, with
+// a_j = alpha^j taken from the field elements, so together with the local
+// sums (the coefficient a_j^0 = 1 within a group) every data block has its
+// own column of powers. The region kernels use GF(2^8) tables, so ctx must
+// be of degree 8; for that and 1 <= groups <= k <= 255, globals >= 0 the
+// code is returned, otherwise one with k = 0 that encode, repairLocal and
+// decode refuse.
+LocalCode makeLocalCode(int k, int groups, int globals,
+                        const FieldContext& ctx) {
+    if (ctx.deg != 8 || groups < 1 || groups > k || k > 255 || globals < 0) {
+        return {0, 0, 0, ctx, {}};
+    }
+    LocalCode code{k, groups, globals, ctx, vector<uint64_t>(globals * k)};
+    for (int j = 0; j < k; j++) {
+        uint64_t a = power(2, j, ctx);
+        uint64_t coefficient = a;
+        for (int i = 0; i < globals; i++) {
+            code.coefficients[i * k + j] = coefficient;
+            coefficient = mulMod(coefficient, a, ctx);
+        }
+    }
+    return code;
+}
+
+int groupSize(const LocalCode& code) {
+    return (code.k + code.groups - 1) / code.groups;
+}
+
+// The group of a data block or local parity, -1 for a global parity.
+int groupOf(const LocalCode& code, int block) {
+    if (block < code.k) {
+        return block / groupSize(code);
+    }
+    return block < code.k + code.groups ? block - code.k : -1;
+}
+
+// The blocks of group g, its data followed by its parity.
+vector<int> groupBlocks(const LocalCode& code, int g) {
+    vector<int> res;
+    int size = groupSize(code);
+    for (int j = g * size; j < min(code.k, (g + 1) * size); j++) {
+        res.push_back(j);
+    }
+    res.push_back(code.k + g);
+    return res;
+}
+
+void encodeGlobal(const LocalCode& code, const vector<uint8_t*>& blocks,
+                  int i, size_t blockSize) {
+    uint8_t* parity = blocks[code.k + code.groups + i];
+    fill(parity, parity + blockSize, 0);
+    for (int j = 0; j < code.k; j++) {
+        mulAddRegion(parity, blocks[j], blockSize,
+                     makeNibbleTables(code.coefficients[i * code.k + j],
+                                      code.ctx));
+    }
+}
+
+// Fills in the local and global parities of blocks from the data blocks.
+bool encode(const LocalCode& code, const vector<uint8_t*>& blocks,
+            size_t blockSize) {
+    if (code.k == 0) {
+        return false;
+    }
+    for (int g = 0; g < code.groups; g++) {
+        vector<int> members = groupBlocks(code, g);
+        uint8_t* parity = blocks[members.back()];
+        fill(parity, parity + blockSize, 0);
+        for (size_t m = 0; m + 1 < members.size(); m++) {
+            xorRegion(parity, blocks[members[m]], blockSize);
+        }
+    }
+    for (int i = 0; i < code.globals; i++) {
+        encodeGlobal(code, blocks, i, blockSize);
+    }
+    return true;
+}
+
+// Rebuilds one lost block. A block of a group is the XOR of the rest of the
+// group; a global parity has no group and is encoded again from the data.
+bool repairLocal(const LocalCode& code, const vector<uint8_t*>& blocks,
+                 int lost, size_t blockSize) {
+    if (code.k == 0) {
+        return false;
+    }
+    int g = groupOf(code, lost);
+    if (g < 0) {
+        encodeGlobal(code, blocks, lost - code.k - code.groups, blockSize);
+        return true;
+    }
+    uint8_t* out = blocks[lost];
+    fill(out, out + blockSize, 0);
+    for (int b : groupBlocks(code, g)) {
+        if (b != lost) {
+            xorRegion(out, blocks[b], blockSize);
+        }
+    }
+    return true;
+}
+
+// Rebuilds all erased blocks. One erasure, or one per group, is repaired
+// locally. Otherwise every surviving parity gives an equation in the lost
+// data blocks: its value plus the known data it covers equals the sum of
+// the lost data it covers. Eliminating over these equations yields each
+// lost block as a combination of them. Returns false if the equations do
+// not determine the lost data, the code is invalid, or blocks or erased do
+// not hold one entry per block.
+bool decode(const LocalCode& code, const vector<uint8_t*>& blocks,
+            const vector<bool>& erased, size_t blockSize) {
+    int k = code.k;
+    int n = k + code.groups + code.globals;
+    if (code.k == 0 || blocks.size() != (size_t)n ||
+        erased.size() != (size_t)n) {
+        return false;
+    }
+    vector<int> lostData;
+    vector<int> lostInGroup(code.groups);
+    bool local = true;
+    for (int b = 0; b < n; b++) {
+        if (!erased[b]) {
+            continue;
+        }
+        if (b < k) {
+            lostData.push_back(b);
+        }
+        int g = groupOf(code, b);
+        local = local && g >= 0 && ++lostInGroup[g] == 1;
+    }
+    if (local) {
+        for (int b = 0; b < n; b++) {
+            if (erased[b]) {
+                repairLocal(code, blocks, b, blockSize);
+            }
+        }
+        return true;
+    }
+
+    // Equations: coefficient of each lost data block in a surviving parity.
+    int unknowns = lostData.size();
+    vector<int> parities;
+    vector<uint64_t> a;
+    auto coefficient = [&](int parity, int j) -> uint64_t {
+        if (parity < k + code.groups) {
+            return groupOf(code, j) == parity - k;
+        }
+        return code.coefficients[(parity - k - code.groups) * k + j];
+    };
+    for (int p = k; p < n; p++) {
+        if (!erased[p]) {
+            parities.push_back(p);
+            for (int j : lostData) {
+                a.push_back(coefficient(p, j));
+            }
+        }
+    }
+
+    // Gauss-Jordan on the equations, recording in combination how each
+    // reduced row is made from the original ones.
+    int rows = parities.size();
+    vector<uint64_t> combination(rows * rows);
+    for (int i = 0; i < rows; i++) {
+        combination[i * rows + i] = 1;
+    }
+    for (int col = 0; col < unknowns; col++) {
+        int pivot = col;
+        while (pivot < rows && a[pivot * unknowns + col] == 0) {
+            pivot++;
+        }
+        if (pivot == rows) {
+            return false;
+        }
+        for (int j = 0; j < unknowns; j++) {
+            swap(a[col * unknowns + j], a[pivot * unknowns + j]);
+        }
+        for (int j = 0; j < rows; j++) {
+            swap(combination[col * rows + j], combination[pivot * rows + j]);
+        }
+        uint64_t scale = inverse(a[col * unknowns + col], code.ctx);
+        for (int j = 0; j < unknowns; j++) {
+            a[col * unknowns + j] = mulMod(a[col * unknowns + j], scale,
+                                           code.ctx);
+        }
+        for (int j = 0; j < rows; j++) {
+            combination[col * rows + j] =
+                mulMod(combination[col * rows + j], scale, code.ctx);
+        }
+        for (int i = 0; i < rows; i++) {
+            uint64_t factor = a[i * unknowns + col];
+            if (i == col || factor == 0) {
+                continue;
+            }
+            for (int j = 0; j < unknowns; j++) {
+                a[i * unknowns + j] ^=
+                    mulMod(factor, a[col * unknowns + j], code.ctx);
+            }
+            for (int j = 0; j < rows; j++) {
+                combination[i * rows + j] ^=
+                    mulMod(factor, combination[col * rows + j], code.ctx);
+            }
+        }
+    }
+
+    // The right-hand side of an equation: the parity plus the surviving
+    // data it covers, built only for the equations that are used.
+    vector<vector<uint8_t>> sides(rows);
+    for (int r = 0; r < rows; r++) {
+        bool used = false;
+        for (int u = 0; u < unknowns; u++) {
+            used = used || combination[u * rows + r] != 0;
+        }
+        if (!used) {
+            continue;
+        }
+        int p = parities[r];
+        sides[r].assign(blocks[p], blocks[p] + blockSize);
+        for (int j = 0; j < k; j++) {
+            uint64_t c = coefficient(p, j);
+            if (erased[j] || c == 0) {
+                continue;
+            }
+            mulAddRegion(sides[r].data(), blocks[j], blockSize,
+                         makeNibbleTables(c, code.ctx));
+        }
+    }
+    for (int u = 0; u < unknowns; u++) {
+        uint8_t* out = blocks[lostData[u]];
+        fill(out, out + blockSize, 0);
+        for (int r = 0; r < rows; r++) {
+            uint64_t c = combination[u * rows + r];
+            if (c != 0) {
+                mulAddRegion(out, sides[r].data(), blockSize,
+                             makeNibbleTables(c, code.ctx));
+            }
+        }
+    }
+
+    // The data is complete again, so lost parities are encoded anew.
+    for (int p = k; p < n; p++) {
+        if (erased[p]) {
+            repairLocal(code, blocks, p, blockSize);
+        }
+    }
+    return true;
+}
+
+// Discrete logarithms in GF(2^q) for a primitive p, q <= 24: exp[i] = x^i
+// for i < 2^q - 1 and log[exp[i]] = i, with log[0] = 0.
+struct LogTables {
+    vector<uint32_t> log;
+    vector<uint64_t> exp;
+};
+
+LogTables makeLogTables(const FieldContext& ctx) {
+    LogTables t;
+    t.log.assign(ctx.mask + 1, 0);
+    t.exp.resize(ctx.mask);
+    uint64_t element = 1;
+    for (uint64_t i = 0; i < ctx.mask; i++) {
+        t.exp[i] = element;
+        t.log[element] = i;
+        element <<= 1;
+        if ((element >> ctx.deg) & 1) {
+            element ^= ctx.modulus;
+        }
+    }
+    return t;
+}
+
+// Multiplication of regions of 16-bit symbols by a constant c of GF(2^16).
+// c * u is the XOR of c times each of the four nibbles of u, and the low and
+// high bytes of those products come from 16-entry tables, eight in all. With
+// the symbols widened so that each nibble index sits in the low byte of its
+// 16-bit lane, PSHUFB looks up a table for 8 symbols at once, or 32 with
+// AVX-512BW; the zero high byte picks c * 0 = 0.
+struct SplitTables16 {
+    // low[i][u] and high[i][u] are the bytes of c * (u << 4i)
+    uint8_t low[4][16];
+    uint8_t high[4][16];
+};
+
+SplitTables16 makeSplitTables16(uint16_t c, const FieldContext& ctx) {
+    SplitTables16 t;
+    for (int i = 0; i < 4; i++) {
+        for (int u = 0; u < 16; u++) {
+            uint64_t product = mulMod(c, (uint64_t)u << (4 * i), ctx);
+            t.low[i][u] = product;
+            t.high[i][u] = product >> 8;
+        }
+    }
+    return t;
+}
+
+// dst[i] ^= c * src[i] for i < count
+void mulAddRegion16(uint16_t* dst, const uint16_t* src, size_t count,
+                    const SplitTables16& t) {
+    size_t i = 0;
+#if defined(__AVX512BW__)
+    __m512i low[4], high[4];
+    for (int j = 0; j < 4; j++) {
+        low[j] = _mm512_maskz_broadcast_i32x4(
+            0xFFFF, _mm_loadu_si128((const __m128i*)t.low[j]));
+        high[j] = _mm512_maskz_broadcast_i32x4(
+            0xFFFF, _mm_loadu_si128((const __m128i*)t.high[j]));
+    }
+    const __m512i nibble = _mm512_set1_epi16(0x000F);
+    for (; i + 32 <= count; i += 32) {
+        __m512i s = _mm512_loadu_si512(src + i);
+        __m512i index[4] = {
+            _mm512_and_si512(s, nibble),
+            _mm512_and_si512(_mm512_srli_epi16(s, 4), nibble),
+            _mm512_and_si512(_mm512_srli_epi16(s, 8), nibble),
+            _mm512_srli_epi16(s, 12)};
+        __m512i productLow = _mm512_setzero_si512();
+        __m512i productHigh = _mm512_setzero_si512();
+        for (int j = 0; j < 4; j++) {
+            productLow = _mm512_xor_si512(
+                productLow, _mm512_shuffle_epi8(low[j], index[j]));
+            productHigh = _mm512_xor_si512(
+                productHigh, _mm512_shuffle_epi8(high[j], index[j]));
+        }
+        __m512i product = _mm512_or_si512(productLow,
+                                          _mm512_slli_epi16(productHigh, 8));
+        _mm512_storeu_si512(
+            dst + i, _mm512_xor_si512(_mm512_loadu_si512(dst + i), product));
+    }
+#elif defined(__SSSE3__)
+    __m128i low[4], high[4];
+    for (int j = 0; j < 4; j++) {
+        low[j] = _mm_loadu_si128((const __m128i*)t.low[j]);
+        high[j] = _mm_loadu_si128((const __m128i*)t.high[j]);
+    }
+    const __m128i nibble = _mm_set1_epi16(0x000F);
+    for (; i + 8 <= count; i += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i index[4] = {_mm_and_si128(s, nibble),
+                            _mm_and_si128(_mm_srli_epi16(s, 4), nibble),
+                            _mm_and_si128(_mm_srli_epi16(s, 8), nibble),
+                            _mm_srli_epi16(s, 12)};
+        __m128i productLow = _mm_setzero_si128();
+        __m128i productHigh = _mm_setzero_si128();
+        for (int j = 0; j < 4; j++) {
+            productLow = _mm_xor_si128(productLow,
+                                       _mm_shuffle_epi8(low[j], index[j]));
+            productHigh = _mm_xor_si128(productHigh,
+                                        _mm_shuffle_epi8(high[j], index[j]));
+        }
+        __m128i product =
+            _mm_or_si128(productLow, _mm_slli_epi16(productHigh, 8));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, product));
+    }
+#endif
+    for (; i < count; i++) {
+        uint16_t product = 0;
+        for (int j = 0; j < 4; j++) {
+            int u = (src[i] >> (4 * j)) & 0x0F;
+            product ^= t.low[j][u] | (t.high[j][u] << 8);
+        }
+        dst[i] ^= product;
+    }
+}
+
+// Reed-Solomon over GF(2^16) for stripes of up to 65536 blocks of 16-bit
+// symbols: k data blocks and m coding blocks, where coding block i is the
+// sum over j of 1 / (i + m + j) times data block j (a Cauchy matrix, so
+// every square submatrix is invertible).
+struct WideCode {
+    int k;
+    int m;
+    FieldContext ctx;
+    vector<uint64_t> matrix;
+};
+
+// The matrix is left empty, and encode and decode refuse the code, unless
+// ctx is of degree 16, k and m are at least 1 and k + m <= 2^16, so that the
+// points i and m + j are distinct.
+WideCode makeWideCode(int k, int m, const FieldContext& ctx) {
+    if (ctx.deg != 16 || k < 1 || m < 1 || (uint64_t)k + m > ctx.mask + 1) {
+        return {k, m, ctx, {}};
+    }
+    WideCode code{k, m, ctx, vector<uint64_t>((size_t)m * k)};
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < k; j++) {
+            code.matrix[(size_t)i * k + j] =
+                inverse((uint64_t)i ^ (m + j), ctx);
+        }
+    }
+    return code;
+}
+
+// Fills in the coding blocks from the data blocks, each of count symbols.
+bool encode(const WideCode& code, const vector<uint16_t*>& blocks,
+            size_t count) {
+    if (code.matrix.empty()) {
+        return false;
+    }
+    threadPool().parallelFor(0, code.m, [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; i++) {
+            uint16_t* parity = blocks[code.k + i];
+            fill(parity, parity + count, 0);
+            for (int j = 0; j < code.k; j++) {
+                mulAddRegion16(parity, blocks[j], count,
+                               makeSplitTables16(
+                                   code.matrix[i * code.k + j], code.ctx));
+            }
+        }
+    });
+    return true;
+}
+
+// Rebuilds the erased blocks. With e data blocks lost, e surviving coding
+// blocks minus their known data terms give e equations whose matrix is an
+// e x e Cauchy submatrix; only that is inverted, not a k x k one. Returns
+// false if more than m blocks are erased, the code is invalid, or blocks
+// or erased do not hold k + m entries.
+bool decode(const WideCode& code, const vector<uint16_t*>& blocks,
+            const vector<bool>& erased, size_t count) {
+    int k = code.k;
+    size_t n = (size_t)k + code.m;
+    if (code.matrix.empty() || blocks.size() != n || erased.size() != n) {
+        return false;
+    }
+    vector<int> lostData, parities;
+    int lost = 0;
+    for (int b = 0; b < k + code.m; b++) {
+        lost += erased[b];
+        if (b < k && erased[b]) {
+            lostData.push_back(b);
+        }
+    }
+    if (lost > code.m) {
+        return false;
+    }
+    int e = lostData.size();
+    for (int b = k; b < k + code.m && (int)parities.size() < e; b++) {
+        if (!erased[b]) {
+            parities.push_back(b);
+        }
+    }
+
+    vector<uint64_t> a(e * e);
+    for (int r = 0; r < e; r++) {
+        for (int c = 0; c < e; c++) {
+            a[r * e + c] = code.matrix[(size_t)(parities[r] - k) * k +
+                                       lostData[c]];
+        }
+    }
+    vector<uint64_t> inverted = invertMatrix(a, e, code.ctx);
+
+    vector<vector<uint16_t>> sides(e);
+    threadPool().parallelFor(0, e, [&](size_t from, size_t to) {
+        for (size_t r = from; r < to; r++) {
+            int p = parities[r];
+            sides[r].assign(blocks[p], blocks[p] + count);
+            for (int j = 0; j < k; j++) {
+                if (!erased[j]) {
+                    mulAddRegion16(
+                        sides[r].data(), blocks[j], count,
+                        makeSplitTables16(
+                            code.matrix[(size_t)(p - k) * k + j], code.ctx));
+                }
+            }
+        }
+    });
+    threadPool().parallelFor(0, e, [&](size_t from, size_t to) {
+        for (size_t c = from; c < to; c++) {
+            uint16_t* out = blocks[lostData[c]];
+            fill(out, out + count, 0);
+            for (int r = 0; r < e; r++) {
+                mulAddRegion16(out, sides[r].data(), count,
+                               makeSplitTables16(inverted[c * e + r],
+                                                 code.ctx));
+            }
+        }
+    });
+
+    // The data is complete, so lost coding blocks are encoded again.
+    for (int i = 0; i < code.m; i++) {
+        if (!erased[k + i]) {
+            continue;
+        }
+        uint16_t* parity = blocks[k + i];
+        fill(parity, parity + count, 0);
+        for (int j = 0; j < k; j++) {
+            mulAddRegion16(parity, blocks[j], count,
+                           makeSplitTables16(code.matrix[(size_t)i * k + j],
+                                             code.ctx));
+        }
+    }
+    return true;
+}
+
+// Gao and Mateer's additive FFT. The points are the affine subspace
+// shift + span(basis[0], ..., basis[m - 1]), point j being shift plus the
+// basis elements picked by the bits of j; with the basis 1, x, x^2, ... and
+// shift 0, point j is simply the element j.
+
+// From this many elements on, the two halves of a transform or a Taylor
+// expansion are worked on in parallel, and so are the products in it.
+const size_t PARALLEL_FFT_SIZE = 1 << 14;
+
+// Rewrites the n coefficients of f, n a power of two, as its expansion in
+// powers of x^2 + x: afterwards f = sum over i of
+// (a[2i] + a[2i + 1] x) (x^2 + x)^i. With T = (x^2 + x)^(n/4) = x^(n/2) +
+// x^(n/4), the two halves f = F0 + T F1 are found with XORs alone and then
+// expanded in turn.
+void taylorExpand(uint64_t* a, size_t n) {
+    if (n <= 2) {
+        return;
+    }
+    size_t quarter = n / 4, half = n / 2;
+    for (size_t j = 0; j < quarter; j++) {
+        a[half + j] ^= a[half + quarter + j];
+    }
+    for (size_t j = 0; j < quarter; j++) {
+        a[quarter + j] ^= a[half + j];
+    }
+    if (n >= PARALLEL_FFT_SIZE) {
+        threadPool().invoke({[=] { taylorExpand(a, half); },
+                             [=] { taylorExpand(a + half, half); }});
+    } else {
+        taylorExpand(a, half);
+        taylorExpand(a + half, half);
+    }
+}
+
+void inverseTaylorExpand(uint64_t* a, size_t n) {
+    if (n <= 2) {
+        return;
+    }
+    size_t quarter = n / 4, half = n / 2;
+    if (n >= PARALLEL_FFT_SIZE) {
+        threadPool().invoke({[=] { inverseTaylorExpand(a, half); },
+                             [=] { inverseTaylorExpand(a + half, half); }});
+    } else {
+        inverseTaylorExpand(a, half);
+        inverseTaylorExpand(a + half, half);
+    }
+    for (size_t j = 0; j < quarter; j++) {
+        a[quarter + j] ^= a[half + j];
+    }
+    for (size_t j = 0; j < quarter; j++) {
+        a[half + j] ^= a[half + quarter + j];
+    }
+}
+
+// Every call at one depth of the recursion sees the same subspace, so what
+// it needs is worked out once. For the last basis element b, g(x) = f(b x)
+// takes the points to s + span(gamma_i) + {0, 1} with s = shift / b and
+// gamma_i = basis[i] / b, and x^2 + x maps those onto s^2 + s +
+// span(gamma_i^2 + gamma_i), the subspace one level down.
+struct FftLevel {
+    vector<uint64_t> powers;         // b^i
+    vector<uint64_t> inversePowers;  // b^-i
+    vector<uint64_t> points;         // s + span(gamma_i), in index order
+};
+
+struct AdditiveFft {
+    int m;
+    FieldContext ctx;
+    vector<FftLevel> levels;  // levels[i] is for subspaces of dimension i + 1
+};
+
+AdditiveFft makeAdditiveFft(int m, uint64_t shift, vector<uint64_t> basis,
+                            const FieldContext& ctx) {
+    AdditiveFft plan{m, ctx, vector<FftLevel>(m)};
+    for (int d = m; d > 0; d--) {
+        FftLevel& level = plan.levels[d - 1];
+        size_t n = (size_t)1 << d;
+        uint64_t b = basis[d - 1], inv = inverse(b, ctx);
+        level.powers.resize(n);
+        level.inversePowers.resize(n);
+        level.powers[0] = level.inversePowers[0] = 1;
+        for (size_t i = 1; i < n; i++) {
+            level.powers[i] = mulMod(level.powers[i - 1], b, ctx);
+            level.inversePowers[i] = mulMod(level.inversePowers[i - 1], inv,
+                                            ctx);
+        }
+        uint64_t gamma[WORD_BITS];
+        for (int i = 0; i + 1 < d; i++) {
+            gamma[i] = mulMod(basis[i], inv, ctx);
+            basis[i] = mulMod(gamma[i], gamma[i], ctx) ^ gamma[i];
+        }
+        uint64_t s = mulMod(shift, inv, ctx);
+        level.points.resize(n / 2);
+        level.points[0] = s;
+        for (size_t j = 1; j < n / 2; j++) {
+            level.points[j] =
+                level.points[j & (j - 1)] ^ gamma[__builtin_ctzll(j)];
+        }
+        shift = mulMod(s, s, ctx) ^ s;
+    }
+    return plan;
+}
+
+// Replaces the 2^d coefficients in a by the values at the points of the
+// level. scratch has room for 2^d elements; each half of it serves one of
+// the two halves of the recursion, so those can run in parallel.
+void additiveFft(const AdditiveFft& plan, int d, uint64_t* a,
+                 uint64_t* scratch) {
+    if (d == 0) {
+        return;
+    }
+    const FftLevel& level = plan.levels[d - 1];
+    size_t n = (size_t)1 << d, half = n / 2;
+    mulModParallel(a, level.powers.data(), a, n, plan.ctx);
+    taylorExpand(a, n);
+    for (size_t i = 0; i < half; i++) {
+        scratch[i] = a[2 * i];
+        scratch[half + i] = a[2 * i + 1];
+    }
+    copy(scratch, scratch + n, a);
+    if (n >= PARALLEL_FFT_SIZE) {
+        threadPool().invoke({
+            [=, &plan] { additiveFft(plan, d - 1, a, scratch); },
+            [=, &plan] {
+                additiveFft(plan, d - 1, a + half, scratch + half);
+            },
+        });
+    } else {
+        additiveFft(plan, d - 1, a, scratch);
+        additiveFft(plan, d - 1, a + half, scratch);
+    }
+
+    // g(x) = G0(x^2 + x) + x G1(x^2 + x) at x and at x + 1
+    mulModParallel(level.points.data(), a + half, scratch, half, plan.ctx);
+    for (size_t j = 0; j < half; j++) {
+        uint64_t w = a[j] ^ scratch[j];
+        a[half + j] ^= w;
+        a[j] = w;
+    }
+}
+
+// The inverse: the values at the points back to 2^d coefficients.
+void additiveIfft(const AdditiveFft& plan, int d, uint64_t* a,
+                  uint64_t* scratch) {
+    if (d == 0) {
+        return;
+    }
+    const FftLevel& level = plan.levels[d - 1];
+    size_t n = (size_t)1 << d, half = n / 2;
+    for (size_t j = 0; j < half; j++) {
+        a[half + j] ^= a[j];
+    }
+    mulModParallel(level.points.data(), a + half, scratch, half, plan.ctx);
+    for (size_t j = 0; j < half; j++) {
+        a[j] ^= scratch[j];
+    }
+    if (n >= PARALLEL_FFT_SIZE) {
+        threadPool().invoke({
+            [=, &plan] { additiveIfft(plan, d - 1, a, scratch); },
+            [=, &plan] {
+                additiveIfft(plan, d - 1, a + half, scratch + half);
+            },
+        });
+    } else {
+        additiveIfft(plan, d - 1, a, scratch);
+        additiveIfft(plan, d - 1, a + half, scratch);
+    }
+
+    for (size_t i = 0; i < half; i++) {
+        scratch[2 * i] = a[i];
+        scratch[2 * i + 1] = a[half + i];
+    }
+    copy(scratch, scratch + n, a);
+    inverseTaylorExpand(a, n);
+    mulModParallel(a, level.inversePowers.data(), a, n, plan.ctx);
+}
+
+void additiveFft(const AdditiveFft& plan, vector<uint64_t>& a) {
+    vector<uint64_t> scratch(a.size());
+    additiveFft(plan, plan.m, a.data(), scratch.data());
+}
+
+void additiveIfft(const AdditiveFft& plan, vector<uint64_t>& a) {
+    vector<uint64_t> scratch(a.size());
+    additiveIfft(plan, plan.m, a.data(), scratch.data());
+}
+
+// The basis 1, x, ..., x^(m - 1), whose span is the elements below 2^m.
+vector<uint64_t> standardBasis(int m) {
+    vector<uint64_t> res(m);
+    for (int i = 0; i < m; i++) {
+        res[i] = 1ULL << i;
+    }
+    return res;
+}
+
+// Reed-Solomon as an evaluation code for long codewords: symbol i is f(i)
+// for a polynomial f of degree below k, the element i being point i of the
+// standard basis, with n <= 2^q. Fills in the erased symbols of codeword in
+// O(N log^2 N) for N the power of two at or above n:
+// - the erasure locator L is the product of (x + e) over the erased
+//   positions and the unused points n..N-1, and log L(i) for every i is the
+//   XOR convolution of the erasure indicator with the log table, done by
+//   Walsh-Hadamard transforms modulo 2^q - 1; taking log 0 as 0 makes it
+//   log L'(e) at an erasure e.
+// - f L is known at every point (zero at erasures), so the inverse FFT gives
+//   its coefficients, and its derivative f' L + f L' equals f(e) L'(e) at an
+//   erasure e.
+// Returns false if more than n - k symbols are erased, or if n > 2^q, which
+// would reuse points.
+bool decodeErasures(vector<uint64_t>& codeword, const vector<bool>& erased,
+                    int k, const FieldContext& ctx, const LogTables& tables) {
+    size_t n = codeword.size();
+    if (n > ctx.mask + 1 || erased.size() != n || k < 0) {
+        return false;
+    }
+    int m = 0;
+    while (((size_t)1 << m) < n) {
+        m++;
+    }
+    size_t size = (size_t)1 << m;
+    size_t lost = count(erased.begin(), erased.end(), true);
+    if (lost + k > n) {
+        return false;
+    }
+    if (lost == 0) {
+        return true;
+    }
+
+    const uint64_t order = ctx.mask;
+    auto walshHadamard = [&](vector<uint64_t>& v) {
+        for (size_t len = 1; len < size; len *= 2) {
+            for (size_t i = 0; i < size; i += 2 * len) {
+                for (size_t j = i; j < i + len; j++) {
+                    uint64_t x = v[j], y = v[j + len];
+                    uint64_t sum = x + y, difference = x + order - y;
+                    v[j] = sum >= order ? sum - order : sum;
+                    v[j + len] =
+                        difference >= order ? difference - order : difference;
+                }
+            }
+        }
+    };
+    vector<uint64_t> locator(size), logs(size);
+    for (size_t i = 0; i < size; i++) {
+        locator[i] = i >= n || erased[i];
+        logs[i] = tables.log[i];
+    }
+    walshHadamard(locator);
+    walshHadamard(logs);
+    for (size_t i = 0; i < size; i++) {
+        locator[i] = (unsigned __int128)locator[i] * logs[i] % order;
+    }
+    walshHadamard(locator);
+    // Divide by size, the inverse of which modulo the odd order is
+    // (order + 1) / 2 to the power m.
+    uint64_t scale = 1;
+    for (int i = 0; i < m; i++) {
+        scale = (unsigned __int128)scale * ((order + 1) / 2) % order;
+    }
+
+    vector<uint64_t> values(size);
+    for (size_t i = 0; i < n; i++) {
+        locator[i] = (unsigned __int128)locator[i] * scale % order;
+        if (!erased[i] && codeword[i] != 0) {
+            values[i] = tables.exp[(tables.log[codeword[i]] + locator[i]) %
+                                   order];
+        }
+    }
+    AdditiveFft plan = makeAdditiveFft(m, 0, standardBasis(m), ctx);
+    additiveIfft(plan, values);
+    for (size_t i = 0; i + 1 < size; i++) {
+        values[i] = i % 2 == 0 ? values[i + 1] : 0;
+    }
+    values[size - 1] = 0;
+    additiveFft(plan, values);
+
+    for (size_t i = 0; i < n; i++) {
+        if (erased[i]) {
+            codeword[i] =
+                values[i] == 0
+                    ? 0
+                    : tables.exp[(tables.log[values[i]] + order - locator[i]) %
+                                 order];
+        }
+    }
+    return true;
+}
+
+// The systematic codeword of length n with the data as its first k symbols,
+// found by decoding the parity positions as erasures. Empty if k > n or
+// n > 2^q.
+vector<uint64_t> encodeEvaluation(const vector<uint64_t>& data, size_t n,
+                                  const FieldContext& ctx,
+                                  const LogTables& tables) {
+    if (data.size() > n || n > ctx.mask + 1) {
+        return {};
+    }
+    vector<uint64_t> codeword(data);
+    codeword.resize(n);
+    vector<bool> erased(n, true);
+    fill(erased.begin(), erased.begin() + data.size(), false);
+    decodeErasures(codeword, erased, data.size(), ctx, tables);
+    return codeword;
+}
+
+#ifdef __linux__
+// Files are encoded a stripe at a time: k blocks read from the input, m
+// coding blocks computed, and block i of every stripe written to file i.
+
+#ifdef HAS_IO_URING
+// A raw io_uring, set up and driven through the system calls: the
+// submission and completion rings are mapped from the kernel and the
+// tails and heads shared with it are read and written with acquire and
+// release ordering.
+struct Uring {
+    int fd = -1;
+    unsigned entries = 0;
+    unsigned queued = 0;  // written to the ring but not yet submitted
+    unsigned *sqHead, *sqTail, *sqArray, sqMask;
+    unsigned *cqHead, *cqTail, cqMask;
+    io_uring_sqe* sqes;
+    io_uring_cqe* cqes;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    void* sqeArea = MAP_FAILED;
+    size_t sqRingSize = 0, cqRingSize = 0, sqeSize = 0;
+
+    explicit Uring(unsigned requested) {
+        io_uring_params params{};
+        fd = syscall(__NR_io_uring_setup, requested, &params);
+        if (fd < 0) {
+            return;
+        }
+        entries = params.sq_entries;
+        sqRingSize = params.sq_off.array + entries * sizeof(unsigned);
+        cqRingSize =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            sqRingSize = cqRingSize = max(sqRingSize, cqRingSize);
+        }
+        sqeSize = entries * sizeof(io_uring_sqe);
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        cqRing = single ? sqRing
+                        : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE, fd,
+                               IORING_OFF_CQ_RING);
+        sqeArea = mmap(nullptr, sqeSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqRing == MAP_FAILED || cqRing == MAP_FAILED ||
+            sqeArea == MAP_FAILED) {
+            release();
+            return;
+        }
+        char* sq = (char*)sqRing;
+        char* cq = (char*)cqRing;
+        sqHead = (unsigned*)(sq + params.sq_off.head);
+        sqTail = (unsigned*)(sq + params.sq_off.tail);
+        sqArray = (unsigned*)(sq + params.sq_off.array);
+        sqMask = *(unsigned*)(sq + params.sq_off.ring_mask);
+        cqHead = (unsigned*)(cq + params.cq_off.head);
+        cqTail = (unsigned*)(cq + params.cq_off.tail);
+        cqMask = *(unsigned*)(cq + params.cq_off.ring_mask);
+        sqes = (io_uring_sqe*)sqeArea;
+        cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+    }
+
+    ~Uring() { release(); }
+
+    void release() {
+        if (sqeArea != MAP_FAILED) {
+            munmap(sqeArea, sqeSize);
+        }
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            munmap(cqRing, cqRingSize);
+        }
+        if (sqRing != MAP_FAILED) {
+            munmap(sqRing, sqRingSize);
+        }
+        sqRing = cqRing = sqeArea = MAP_FAILED;
+        if (fd >= 0) {
+            close(fd);
+        }
+        fd = -1;
+    }
+
+    // Passes the queued entries to the kernel, waiting for at least
+    // waitFor completions.
+    int enter(unsigned waitFor) {
+        int ret;
+        do {
+            ret = syscall(__NR_io_uring_enter, fd, queued, waitFor,
+                          waitFor > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr,
+                          0);
+        } while (ret < 0 && errno == EINTR);
+        if (ret > 0) {
+            queued -= ret;
+        }
+        return ret;
+    }
+
+    // A cleared entry at the tail of the submission ring.
+    io_uring_sqe* next() {
+        unsigned tail = *sqTail;
+        while (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) == entries) {
+            enter(0);
+        }
+        unsigned index = tail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        queued++;
+        return sqe;
+    }
+
+    bool reap(io_uring_cqe& cqe) {
+        unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        cqe = cqes[head & cqMask];
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+};
+#endif
+
+// A read or write of length bytes at offset in fd, for one of the buffers
+// of the pipeline. A read reaching fileSize, when the size is known, ends
+// there and the rest of the request is zeroed.
+struct IoRequest {
+    int fd;
+    uint8_t* data;
+    size_t length;
+    uint64_t offset;
+    bool write;
+    int slot;
+    uint64_t fileSize = UINT64_MAX;
+};
+
+// The reads and writes of the pipeline. With a ring they are queued in
+// batches and complete while the caller works on another slot, into the
+// slot buffers registered with the kernel when it allows, which saves
+// mapping the pages on every request. Without one they are done on the
+// spot with pread and pwrite. A short transfer is continued where it
+// stopped, except for a read at the end of the file, which leaves the rest
+// of the request zeroed.
+struct FileIo {
+#ifdef HAS_IO_URING
+    Uring ring;
+#endif
+    bool async = false;
+    bool registered = false;
+    vector<iovec> buffers;
+    vector<IoRequest> requests;
+    vector<size_t> unused;
+    size_t pending[2] = {0, 0};
+    bool failed = false;
+
+    FileIo(unsigned entries, const vector<iovec>& slotBuffers, bool useRing)
+#ifdef HAS_IO_URING
+        : ring(useRing ? entries : 0)
+#endif
+    {
+        buffers = slotBuffers;
+#ifdef HAS_IO_URING
+        async = useRing && ring.fd >= 0;
+        if (async) {
+            registered = syscall(__NR_io_uring_register, ring.fd,
+                                 IORING_REGISTER_BUFFERS, buffers.data(),
+                                 buffers.size()) == 0;
+            requests.resize(ring.entries);
+            for (size_t i = 0; i < requests.size(); i++) {
+                unused.push_back(i);
+            }
+        }
+#endif
+    }
+
+    static bool transfer(IoRequest r) {
+        while (r.length > 0) {
+            if (!r.write && r.offset >= r.fileSize) {
+                memset(r.data, 0, r.length);
+                return true;
+            }
+            ssize_t done = r.write ? pwrite(r.fd, r.data, r.length, r.offset)
+                                   : pread(r.fd, r.data, r.length, r.offset);
+            if (done < 0 && errno == EINTR) {
+                continue;
+            }
+            if (done <= 0) {
+                if (done == 0 && !r.write) {
+                    memset(r.data, 0, r.length);
+                    return true;
+                }
+                return false;
+            }
+            r.data += done;
+            r.length -= done;
+            r.offset += done;
+        }
+        return true;
+    }
+
+    void submit(const IoRequest& r) {
+        if (!async) {
+            failed = failed || !transfer(r);
+            return;
+        }
+#ifdef HAS_IO_URING
+        while (unused.empty()) {
+            complete(1);
+        }
+        size_t id = unused.back();
+        unused.pop_back();
+        requests[id] = r;
+        queue(id);
+        pending[r.slot]++;
+#endif
+    }
+
+#ifdef HAS_IO_URING
+    // Writes request id to the submission ring.
+    void queue(size_t id) {
+        const IoRequest& r = requests[id];
+        io_uring_sqe* sqe = ring.next();
+        sqe->fd = r.fd;
+        sqe->addr = (uint64_t)r.data;
+        sqe->len = r.length;
+        sqe->off = r.offset;
+        sqe->user_data = id;
+        sqe->opcode = r.write ? IORING_OP_WRITE : IORING_OP_READ;
+        if (registered) {
+            sqe->opcode =
+                r.write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+            sqe->buf_index = r.slot;
+        }
+    }
+#endif
+
+    // Hands the queued requests to the kernel without waiting.
+    void flush() {
+#ifdef HAS_IO_URING
+        if (async && ring.queued > 0) {
+            ring.enter(0);
+        }
+#endif
+    }
+
+    // Handles the finished requests, waiting for at least waitFor.
+    void complete(unsigned waitFor) {
+#ifdef HAS_IO_URING
+        if (ring.enter(waitFor) < 0 && errno != EBUSY) {
+            failed = true;
+            return;
+        }
+        io_uring_cqe cqe;
+        while (ring.reap(cqe)) {
+            IoRequest& r = requests[cqe.user_data];
+            if (cqe.res < 0 || (cqe.res == 0 && r.write)) {
+                failed = true;
+            } else if ((size_t)cqe.res < r.length) {
+                r.data += cqe.res;
+                r.length -= cqe.res;
+                r.offset += cqe.res;
+                if (r.write || (cqe.res > 0 && r.offset < r.fileSize)) {
+                    // The rest goes back to the kernel under the same id.
+                    queue(cqe.user_data);
+                    continue;
+                }
+                memset(r.data, 0, r.length);
+            }
+            pending[r.slot]--;
+            unused.push_back(cqe.user_data);
+        }
+#else
+        (void)waitFor;
+#endif
+    }
+
+    void wait(int slot) {
+        while (pending[slot] > 0 && !failed) {
+            complete(1);
+        }
+    }
+};
+
+// Runs the stripes through read, process and write with two slots: while
+// stripe s is processed, stripe s + 1 is read into the other slot, and the
+// writes of s go on while the next iteration waits for that read. A failed
+// request or process call stops the pipeline once nothing is in flight.
+bool runPipeline(FileIo& io, size_t stripes,
+                 const function<void(size_t, int)>& read,
+                 const function<bool(size_t, int)>& process,
+                 const function<void(size_t, int)>& write) {
+    if (stripes > 0) {
+        read(0, 0);
+        io.flush();
+    }
+    for (size_t s = 0; s < stripes && !io.failed; s++) {
+        int slot = s % 2;
+        io.wait(slot);
+        io.wait(1 - slot);
+        if (io.failed) {
+            break;
+        }
+        if (s + 1 < stripes) {
+            read(s + 1, 1 - slot);
+            io.flush();
+        }
+        if (!process(s, slot)) {
+            io.failed = true;
+            break;
+        }
+        write(s, slot);
+        io.flush();
+    }
+    // Failed or not, the kernel must be done with the buffers.
+    bool failed = io.failed;
+    io.failed = false;
+    io.wait(0);
+    io.wait(1);
+    return !failed && !io.failed;
+}
+
+// Opens with O_DIRECT if asked and the file system allows it.
+int openFile(const string& path, int flags, bool direct) {
+    int fd = -1;
+    if (direct) {
+        fd = open(path.c_str(), flags | O_DIRECT, 0644);
+    }
+    if (fd < 0) {
+        fd = open(path.c_str(), flags, 0644);
+    }
+    return fd;
+}
+
+// Two slots of n blocks, page aligned as O_DIRECT wants.
+struct SlotBuffers {
+    size_t bytes;
+    unique_ptr<uint8_t, decltype(&free)> memory;
+
+    SlotBuffers(int n, size_t blockSize)
+        : bytes((n * blockSize + 4095) / 4096 * 4096),
+          memory((uint8_t*)aligned_alloc(4096, 2 * bytes), &free) {}
+
+    uint8_t* slot(int s) const { return memory.get() + s * bytes; }
+
+    vector<uint8_t*> blocks(int s, int n, size_t blockSize) const {
+        vector<uint8_t*> res(n);
+        for (int i = 0; i < n; i++) {
+            res[i] = slot(s) + i * blockSize;
+        }
+        return res;
+    }
+
+    vector<iovec> iovecs() const {
+        return {{slot(0), bytes}, {slot(1), bytes}};
+    }
+};
+
+// Splits input into stripes of k blocks, encodes each with encodeStripe
+// and writes block i of every stripe to outputs[i]; the last stripe is
+// padded with zeros. direct asks for O_DIRECT, which needs blockSize to be
+// a multiple of 4096, and useRing = false does all I/O with pread and
+// pwrite.
+bool encodeFile(
+    const string& input, const vector<string>& outputs, int k,
+    size_t blockSize,
+    const function<void(const vector<uint8_t*>&, size_t)>& encodeStripe,
+    bool direct = false, bool useRing = true) {
+    int n = outputs.size();
+    direct = direct && blockSize % 4096 == 0;
+    int in = openFile(input, O_RDONLY, direct);
+    vector<int> out(n, -1);
+    bool opened = in >= 0;
+    for (int i = 0; i < n; i++) {
+        out[i] = openFile(outputs[i], O_WRONLY | O_CREAT | O_TRUNC, direct);
+        opened = opened && out[i] >= 0;
+    }
+    struct stat info;
+    bool ok = opened && fstat(in, &info) == 0;
+    SlotBuffers buffers(n, blockSize);
+    ok = ok && buffers.memory;
+    if (ok) {
+        FileIo io(2 * n + 2, buffers.iovecs(), useRing);
+        size_t stripeBytes = k * blockSize;
+        size_t stripes = (info.st_size + stripeBytes - 1) / stripeBytes;
+        ok = runPipeline(
+            io, stripes,
+            [&](size_t s, int slot) {
+                io.submit({in, buffers.slot(slot), stripeBytes,
+                           s * stripeBytes, false, slot,
+                           (uint64_t)info.st_size});
+            },
+            [&](size_t, int slot) {
+                encodeStripe(buffers.blocks(slot, n, blockSize), blockSize);
+                return true;
+            },
+            [&](size_t s, int slot) {
+                for (int i = 0; i < n; i++) {
+                    io.submit({out[i], buffers.slot(slot) + i * blockSize,
+                               blockSize, s * blockSize, true, slot});
+                }
+            });
+    }
+    for (int fd : out) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    if (in >= 0) {
+        close(in);
+    }
+    return ok;
+}
+
+// Rebuilds the size bytes of the original file into output from the block
+// files of encodeFile, the erased ones not being read; decodeStripe fills
+// in the erased blocks of a stripe or returns false.
+bool decodeFile(const vector<string>& inputs, const vector<bool>& erased,
+                int k, size_t blockSize, uint64_t size, const string& output,
+                const function<bool(const vector<uint8_t*>&,
+                                    const vector<bool>&, size_t)>& decodeStripe,
+                bool direct = false, bool useRing = true) {
+    int n = inputs.size();
+    direct = direct && blockSize % 4096 == 0;
+    vector<int> in(n, -1);
+    bool ok = true;
+    for (int i = 0; i < n; i++) {
+        if (!erased[i]) {
+            in[i] = openFile(inputs[i], O_RDONLY, direct);
+            ok = ok && in[i] >= 0;
+        }
+    }
+    int out = openFile(output, O_WRONLY | O_CREAT | O_TRUNC, direct);
+    SlotBuffers buffers(n, blockSize);
+    ok = ok && out >= 0 && buffers.memory;
+    if (ok) {
+        FileIo io(2 * n + 2, buffers.iovecs(), useRing);
+        size_t stripeBytes = k * blockSize;
+        size_t stripes = (size + stripeBytes - 1) / stripeBytes;
+        ok = runPipeline(
+                 io, stripes,
+                 [&](size_t s, int slot) {
+                     for (int i = 0; i < n; i++) {
+                         if (!erased[i]) {
+                             io.submit({in[i],
+                                        buffers.slot(slot) + i * blockSize,
+                                        blockSize, s * blockSize, false,
+                                        slot});
+                         }
+                     }
+                 },
+                 [&](size_t, int slot) {
+                     return decodeStripe(buffers.blocks(slot, n, blockSize),
+                                         erased, blockSize);
+                 },
+                 [&](size_t s, int slot) {
+                     io.submit({out, buffers.slot(slot), stripeBytes,
+                                s * stripeBytes, true, slot});
+                 }) &&
+             ftruncate(out, size) == 0;
+    }
+    for (int fd : in) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    if (out >= 0) {
+        close(out);
+    }
+    return ok;
+}
+#endif
+
+// Binary Goppa codes as in Classic McEliece. The private key is a monic
+// irreducible polynomial g of degree t over GF(2^m) and a support of n
+// distinct elements alpha_j; column j of the parity-check matrix is
+// alpha_j^i / g(alpha_j) for i < t, each element written as m bits. The
+// public key is that matrix brought to the systematic form [I | T] over
+// GF(2). Polynomials over the field are vectors of coefficients, low first.
+
+// The degree of gcd(a, b), -1 if both are zero.
+int gcdDegree(vector<uint64_t> a, vector<uint64_t> b,
+              const FieldContext& ctx) {
+    auto trim = [](vector<uint64_t>& p) {
+        while (!p.empty() && p.back() == 0) {
+            p.pop_back();
+        }
+    };
+    trim(a);
+    trim(b);
+    while (!b.empty()) {
+        uint64_t inv = inverse(b.back(), ctx);
+        for (uint64_t& c : b) {
+            c = mulMod(c, inv, ctx);
+        }
+        int d = b.size() - 1;
+        for (int i = (int)a.size() - 1; i >= d; i--) {
+            uint64_t c = a[i];
+            for (int j = 0; j <= d; j++) {
+                a[i - d + j] ^= mulMod(c, b[j], ctx);
+            }
+        }
+        trim(a);
+        swap(a, b);
+    }
+    return (int)a.size() - 1;
+}
+
+// Ben-Or's test for a monic g of degree t >= 2: g is irreducible iff
+// gcd(x^(Q^i) - x, g) = 1 for i <= t / 2, Q = 2^m. Raising to the power Q
+// is m squarings, and squaring mod g is linear over GF(2): the square of
+// sum a_i x^i is sum a_i^2 (x^(2i) mod g), so each coefficient of the
+// result is a dot product with a precomputed column and is reduced once.
+bool isIrreducibleOver(const vector<uint64_t>& g, const FieldContext& ctx) {
+    int t = g.size() - 1;
+    vector<vector<uint64_t>> columns(t, vector<uint64_t>(t));
+    vector<uint64_t> power(t + 2);
+    power[0] = 1;
+    for (int i = 0; i < t; i++) {
+        for (int j = 0; j < t; j++) {
+            columns[j][i] = power[j];
+        }
+        // times x^2, then the two coefficients past t - 1 folded back
+        rotate(power.rbegin(), power.rbegin() + 2, power.rend());
+        for (int k = t + 1; k >= t; k--) {
+            uint64_t c = power[k];
+            power[k] = 0;
+            for (int j = 0; j < t; j++) {
+                power[k - t + j] ^= mulMod(c, g[j], ctx);
+            }
+        }
+    }
+
+    vector<uint64_t> h(t), squares(t);
+    h[1] = 1;
+    for (int i = 1; i <= t / 2; i++) {
+        for (int s = 0; s < ctx.deg; s++) {
+            for (int j = 0; j < t; j++) {
+                squares[j] = mulMod(h[j], h[j], ctx);
+            }
+            for (int j = 0; j < t; j++) {
+                h[j] = dot(squares, columns[j], ctx);
+            }
+        }
+        vector<uint64_t> difference = h;
+        difference[1] ^= 1;
+        if (gcdDegree(g, difference, ctx) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// dst ^= src & mask over count words, as xorRegion
+void xorWordsMasked(uint64_t* dst, const uint64_t* src, size_t count,
+                    uint64_t mask) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    __m512i m = _mm512_set1_epi64(mask);
+    for (; i + 8 <= count; i += 8) {
+        __m512i d = _mm512_loadu_si512(dst + i);
+        __m512i s = _mm512_and_si512(_mm512_loadu_si512(src + i), m);
+        _mm512_storeu_si512(dst + i, _mm512_xor_si512(d, s));
+    }
+#elif defined(__AVX2__)
+    __m256i m = _mm256_set1_epi64x(mask);
+    for (; i + 4 <= count; i += 4) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i s = _mm256_and_si256(
+            _mm256_loadu_si256((const __m256i*)(src + i)), m);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, s));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] ^= src[i] & mask;
+    }
+}
+
+// Brings the bit matrix of rows rows, words words each, to [I | T] by
+// Gauss-Jordan elimination over GF(2); false if the left square block is
+// singular. The key is secret, so rows are added under masks instead of
+// branches: each pivot row first takes every row below that differs from
+// it in the pivot column, then is added to every row with a one there.
+// The additions run a vector at a time from the pivot column on, and the
+// clearing pass, most of the work, is split over the thread pool.
+bool systematize(vector<uint64_t>& matrix, int rows, size_t words) {
+    for (int r = 0; r < rows; r++) {
+        size_t w = r / WORD_BITS;
+        int bit = r % WORD_BITS;
+        uint64_t* pivot = &matrix[r * words];
+        for (int k = r + 1; k < rows; k++) {
+            const uint64_t* row = &matrix[k * words];
+            uint64_t mask = -(((pivot[w] ^ row[w]) >> bit) & 1);
+            xorWordsMasked(pivot + w, row + w, words - w, mask);
+        }
+        if (((pivot[w] >> bit) & 1) == 0) {
+            return false;
+        }
+        threadPool().parallelFor(
+            0, rows,
+            [&](size_t from, size_t to) {
+                for (size_t k = from; k < to; k++) {
+                    if ((int)k == r) {
+                        continue;
+                    }
+                    uint64_t* row = &matrix[k * words];
+                    uint64_t mask = -((row[w] >> bit) & 1);
+                    xorWordsMasked(row + w, pivot + w, words - w, mask);
+                }
+            },
+            64);
+    }
+    return true;
+}
+
+struct GoppaKey {
+    int m;
+    int t;
+    int n;
+    FieldContext ctx;
+    // private
+    vector<uint64_t> goppa;
+    vector<uint64_t> support;
+    vector<uint64_t> weights;  // 1 / g(alpha_j)^2
+    // public: row r of T is words words from publicKey[r * words]
+    size_t words;
+    vector<uint64_t> publicKey;
+};
+
+// A key for a code of length n correcting t errors over the field of ctx,
+// which should be constant time. g is drawn until irreducible, then the
+// support is drawn until the parity-check matrix is systematic, about
+// 29% of draws. Empty publicKey if the parameters are invalid (t < 2,
+// n <= mt or n > 2^m) or /dev/urandom cannot be read.
+GoppaKey generateGoppaKey(int t, int n, const FieldContext& ctx) {
+    int m = ctx.deg, rows = m * t;
+    GoppaKey key{m, t, n, ctx, {}, {}, {}, 0, {}};
+    if (t < 2 || n <= rows || (uint64_t)n > ctx.mask + 1) {
+        return key;
+    }
+    ifstream random("/dev/urandom", ios::binary);
+    auto next = [&]() {
+        uint64_t value = 0;
+        random.read((char*)&value, sizeof(value));
+        return value;
+    };
+
+    vector<uint64_t> g(t + 1);
+    do {
+        for (int i = 0; i < t; i++) {
+            g[i] = next() & ctx.mask;
+        }
+        g[t] = 1;
+    } while (random && !isIrreducibleOver(g, ctx));
+
+    size_t words = (n + WORD_BITS - 1) / WORD_BITS;
+    vector<uint64_t> matrix;
+    vector<uint64_t> support(ctx.mask + 1);
+    while (random) {
+        iota(support.begin(), support.end(), 0);
+        for (int j = 0; j < n; j++) {
+            swap(support[j], support[j + next() % (support.size() - j)]);
+        }
+        vector<uint64_t> alpha(support.begin(), support.begin() + n);
+        vector<uint64_t> values = hornerEval(g, alpha, ctx);
+        matrix.assign(rows * words, 0);
+        for (int j = 0; j < n; j++) {
+            uint64_t e = inverse(values[j], ctx);
+            values[j] = mulMod(e, e, ctx);
+            for (int i = 0; i < t; i++) {
+                for (int b = 0; b < m; b++) {
+                    matrix[(i * m + b) * words + j / WORD_BITS] |=
+                        ((e >> b) & 1) << (j % WORD_BITS);
+                }
+                e = mulMod(e, alpha[j], ctx);
+            }
+        }
+        if (!systematize(matrix, rows, words)) {
+            continue;
+        }
+
+        key.goppa = g;
+        key.support = alpha;
+        key.weights = values;
+        key.words = (n - rows + WORD_BITS - 1) / WORD_BITS;
+        key.publicKey.resize(rows * key.words);
+        for (int r = 0; r < rows; r++) {
+            vector<uint64_t> row(matrix.begin() + r * words,
+                                 matrix.begin() + (r + 1) * words);
+            for (size_t w = 0; w < key.words; w++) {
+                key.publicKey[r * key.words + w] =
+                    extractWord(row, rows + w * WORD_BITS);
+            }
+        }
+        break;
+    }
+    return key;
+}
+
+// The syndrome [I | T] e of an error vector of n bits, mt bits long: what a
+// Niederreiter sender computes from the public key.
+vector<uint64_t> goppaSyndrome(const GoppaKey& key,
+                               const vector<uint64_t>& error) {
+    int rows = key.m * key.t;
+    vector<uint64_t> tail(key.words);
+    for (size_t w = 0; w < key.words; w++) {
+        tail[w] = extractWord(error, rows + w * WORD_BITS);
+    }
+    vector<uint64_t> res((rows + WORD_BITS - 1) / WORD_BITS);
+    for (int r = 0; r < rows; r++) {
+        uint64_t acc = (error[r / WORD_BITS] >> (r % WORD_BITS)) & 1;
+        const uint64_t* row = &key.publicKey[r * key.words];
+        uint64_t product = 0;
+        for (size_t w = 0; w < key.words; w++) {
+            product ^= row[w] & tail[w];
+        }
+        acc ^= __builtin_parityll(product);
+        res[r / WORD_BITS] |= acc << (r % WORD_BITS);
+    }
+    return res;
+}
+
+// The error vector of weight at most t with the given syndrome, or empty.
+// (s, 0) has the syndrome s too, as [I | T] and the private parity-check
+// matrix have the same null space, and since g is squarefree the code is
+// also the Goppa code of g^2, which gives 2t syndromes
+// S_i = sum over the ones j of alpha_j^i / g(alpha_j)^2. Berlekamp-Massey
+// then finds the error locator, with its updates masked so that it runs
+// the same for every syndrome, and the reversed locator is evaluated on
+// the whole support.
+vector<uint64_t> decodeGoppa(const GoppaKey& key,
+                             const vector<uint64_t>& syndrome) {
+    const FieldContext& ctx = key.ctx;
+    int t = key.t, rows = key.m * t;
+    vector<uint64_t> s(2 * t);
+    for (int j = 0; j < rows; j++) {
+        uint64_t bit = (syndrome[j / WORD_BITS] >> (j % WORD_BITS)) & 1;
+        uint64_t term = key.weights[j] & -bit;
+        for (int i = 0; i < 2 * t; i++) {
+            s[i] ^= term;
+            term = mulMod(term, key.support[j], ctx);
+        }
+    }
+
+    vector<uint64_t> locator(2 * t + 1), previous(2 * t + 1), saved;
+    locator[0] = previous[0] = 1;
+    uint64_t last = 1;
+    int length = 0;
+    for (int step = 0; step < 2 * t; step++) {
+        uint64_t d = 0;
+        for (int i = 0; i <= step; i++) {
+            d ^= mulMod(locator[i], s[step - i], ctx);
+        }
+        uint64_t grow = -(uint64_t)(d != 0) & -(uint64_t)(2 * length <= step);
+        uint64_t f = mulMod(d, inverse(last, ctx), ctx);
+        saved = locator;
+        // previous holds the last locator times x^(steps since)
+        rotate(previous.rbegin(), previous.rbegin() + 1, previous.rend());
+        for (int i = 0; i <= 2 * t; i++) {
+            locator[i] ^= mulMod(f, previous[i], ctx);
+            previous[i] = (saved[i] & grow) | (previous[i] & ~grow);
+        }
+        length = (int)(((uint64_t)(step + 1 - length) & grow) |
+                       ((uint64_t)length & ~grow));
+        last = (d & grow) | (last & ~grow);
+    }
+    if (length > t) {
+        return {};
+    }
+
+    // x^length locator(1 / x), picked without indexing by length
+    vector<uint64_t> reversed(t + 1);
+    for (int i = 0; i <= t; i++) {
+        for (int k = 0; k <= t; k++) {
+            reversed[i] ^= locator[k] & -(uint64_t)(k + i == length);
+        }
+    }
+    vector<uint64_t> values = hornerEval(reversed, key.support, ctx);
+    vector<uint64_t> error((key.n + WORD_BITS - 1) / WORD_BITS);
+    int weight = 0;
+    for (int j = 0; j < key.n; j++) {
+        uint64_t root = values[j] == 0;
+        error[j / WORD_BITS] |= root << (j % WORD_BITS);
+        weight += root;
+    }
+    if (weight != length || goppaSyndrome(key, error) != syndrome) {
+        return {};
+    }
+    return error;
+}
+
+// Polynomials over GF(2^q), as vectors of coefficients with the low one
+// first, multiplied by schoolbook, Karatsuba or the additive FFT by size.
+
+// Below this many coefficients per operand multiplication is schoolbook.
+const int FIELD_KARATSUBA_THRESHOLD = 24;
+// From this many coefficients per operand on, the three half-size products
+// are computed in parallel.
+const size_t FIELD_PARALLEL_KARATSUBA_THRESHOLD = 128;
+// From this many coefficients in the product on, with operands of at least
+// half as many and a field with room for a subspace of that size,
+// multiplication goes through the FFT.
+const size_t FIELD_FFT_THRESHOLD = 8192;
+
+// out[0, an + bn - 1) ^= a * b, each coefficient of the product summed
+// unreduced and reduced once.
+void mulSchoolbook(const uint64_t* a, size_t an, const uint64_t* b,
+                   size_t bn, uint64_t* out, const FieldContext& ctx) {
+    for (size_t k = 0; k + 1 < an + bn; k++) {
+        size_t from = k < bn ? 0 : k - bn + 1;
+        size_t to = min(k, an - 1);
+        unsigned __int128 acc = 0;
+        for (size_t i = from; i <= to; i++) {
+            acc ^= clmul(a[i], b[k - i]);
+        }
+        out[k] ^= reduce(acc, ctx);
+    }
+}
+
+// out[0, 2n - 1) ^= a * b, where both operands have n coefficients; as
+// mulKaratsuba but with field elements for words.
+void mulKaratsuba(const uint64_t* a, const uint64_t* b, size_t n,
+                  uint64_t* out, const FieldContext& ctx) {
+    if (n < (size_t)FIELD_KARATSUBA_THRESHOLD) {
+        mulSchoolbook(a, n, b, n, out, ctx);
+        return;
+    }
+
+    size_t low = n / 2;
+    size_t high = n - low;
+
+    Arena& arena = threadArena();
+    ArenaScope scope(arena);
+    uint64_t* aSum = arena.allocateWords(high);
+    uint64_t* bSum = arena.allocateWords(high);
+    copy(a + low, a + n, aSum);
+    copy(b + low, b + n, bSum);
+    for (size_t i = 0; i < low; i++) {
+        aSum[i] ^= a[i];
+        bSum[i] ^= b[i];
+    }
+
+    uint64_t* z0 = arena.allocateWords(2 * low - 1);
+    uint64_t* z1 = arena.allocateWords(2 * high - 1);
+    uint64_t* z2 = arena.allocateWords(2 * high - 1);
+    fill(z0, z0 + 2 * low - 1, 0);
+    fill(z1, z1 + 2 * high - 1, 0);
+    fill(z2, z2 + 2 * high - 1, 0);
+    if (n >= FIELD_PARALLEL_KARATSUBA_THRESHOLD) {
+        threadPool().invoke({
+            [=, &ctx] { mulKaratsuba(aSum, bSum, high, z1, ctx); },
+            [=, &ctx] { mulKaratsuba(a, b, low, z0, ctx); },
+            [=, &ctx] { mulKaratsuba(a + low, b + low, high, z2, ctx); },
+        });
+    } else {
+        mulKaratsuba(a, b, low, z0, ctx);
+        mulKaratsuba(a + low, b + low, high, z2, ctx);
+        mulKaratsuba(aSum, bSum, high, z1, ctx);
+    }
+
+    for (size_t i = 0; i < 2 * low - 1; i++) {
+        z1[i] ^= z0[i];
+        out[i] ^= z0[i];
+    }
+    for (size_t i = 0; i < 2 * high - 1; i++) {
+        z1[i] ^= z2[i];
+        out[i + 2 * low] ^= z2[i];
+    }
+    for (size_t i = 0; i < 2 * high - 1; i++) {
+        out[i + low] ^= z1[i];
+    }
+}
+
+// The product through the additive FFT: both operands evaluated on the
+// first size elements, multiplied pointwise and interpolated.
+vector<uint64_t> mulFft(const vector<uint64_t>& a, const vector<uint64_t>& b,
+                        const FieldContext& ctx) {
+    size_t length = a.size() + b.size() - 1;
+    int m = 0;
+    while (((size_t)1 << m) < length) {
+        m++;
+    }
+    AdditiveFft plan = makeAdditiveFft(m, 0, standardBasis(m), ctx);
+    vector<uint64_t> x(a), y(b);
+    x.resize((size_t)1 << m);
+    y.resize((size_t)1 << m);
+    threadPool().invoke({[&] { additiveFft(plan, x); },
+                         [&] { additiveFft(plan, y); }});
+    mulMod(x, y, x, ctx);
+    additiveIfft(plan, x);
+    x.resize(length);
+    return x;
+}
+
+vector<uint64_t> mulFieldPoly(const vector<uint64_t>& a,
+                              const vector<uint64_t>& b,
+                              const FieldContext& ctx) {
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    size_t an = a.size(), bn = b.size(), length = an + bn - 1;
+    if (length >= FIELD_FFT_THRESHOLD && length <= ctx.mask + 1 &&
+        min(an, bn) >= FIELD_FFT_THRESHOLD / 2) {
+        return mulFft(a, b, ctx);
+    }
+    vector<uint64_t> res(length);
+    if (min(an, bn) < (size_t)FIELD_KARATSUBA_THRESHOLD) {
+        mulSchoolbook(a.data(), an, b.data(), bn, res.data(), ctx);
+        return res;
+    }
+    // The longer operand in slices as long as the shorter one
+    const vector<uint64_t>& longer = an >= bn ? a : b;
+    const vector<uint64_t>& shorter = an >= bn ? b : a;
+    size_t n = shorter.size();
+    Arena& arena = threadArena();
+    ArenaScope scope(arena);
+    uint64_t* slice = arena.allocateWords(n);
+    uint64_t* product = arena.allocateWords(2 * n - 1);
+    for (size_t from = 0; from < longer.size(); from += n) {
+        size_t count = min(n, longer.size() - from);
+        copy(longer.begin() + from, longer.begin() + from + count, slice);
+        fill(slice + count, slice + n, 0);
+        fill(product, product + 2 * n - 1, 0);
+        mulKaratsuba(slice, shorter.data(), n, product, ctx);
+        for (size_t i = 0; i < count + n - 1; i++) {
+            res[from + i] ^= product[i];
+        }
+    }
+    return res;
+}
+
+// 1 / f mod x^k for f[0] != 0 by Newton's iteration, which over
+// characteristic 2 is g <- f g^2, doubling the correct coefficients.
+vector<uint64_t> inverseSeries(const vector<uint64_t>& f, size_t k,
+                               const FieldContext& ctx) {
+    vector<uint64_t> g = {inverse(f[0], ctx)};
+    for (size_t precision = 1; precision < k;) {
+        precision = min(2 * precision, k);
+        vector<uint64_t> square(2 * g.size() - 1);
+        for (size_t i = 0; i < g.size(); i++) {
+            square[2 * i] = mulMod(g[i], g[i], ctx);
+        }
+        square.resize(min(square.size(), precision));
+        vector<uint64_t> head(f.begin(),
+                              f.begin() + min(f.size(), precision));
+        g = mulFieldPoly(head, square, ctx);
+        g.resize(precision);
+    }
+    g.resize(k);
+    return g;
+}
+
+// a mod b for b of degree d >= 0, as a d-coefficient vector. With a of
+// degree n the quotient reversed is rev(a) / rev(b) mod x^(n - d + 1);
+// reversedInverse may hold 1 / rev(b) to some precision, which is extended
+// when short.
+vector<uint64_t> modFieldPoly(const vector<uint64_t>& a,
+                              const vector<uint64_t>& b,
+                              const vector<uint64_t>& reversedInverse,
+                              const FieldContext& ctx) {
+    size_t d = b.size() - 1;
+    if (a.size() <= d) {
+        vector<uint64_t> res(a);
+        res.resize(d);
+        return res;
+    }
+    size_t k = a.size() - d;
+    vector<uint64_t> inv = reversedInverse;
+    if (inv.size() < k) {
+        inv = inverseSeries(vector<uint64_t>(b.rbegin(), b.rend()), k, ctx);
+    }
+    inv.resize(k);
+    vector<uint64_t> quotient =
+        mulFieldPoly(vector<uint64_t>(a.rbegin(), a.rbegin() + k), inv, ctx);
+    quotient.resize(k);
+    reverse(quotient.begin(), quotient.end());
+    vector<uint64_t> product = mulFieldPoly(quotient, b, ctx);
+    vector<uint64_t> res(a.begin(), a.begin() + d);
+    for (size_t i = 0; i < d; i++) {
+        res[i] ^= product[i];
+    }
+    return res;
+}
+
+// Multipoint evaluation and interpolation at arbitrary points with a
+// subproduct tree: node j of level l is the product of x + u_i over the
+// points of its range [j 2^l, (j + 1) 2^l), level 0 holding x + u_i. A
+// node also keeps 1 / rev(node) to the precision its remainders need.
+// Both directions then cost O(M(n) log n).
+struct SubproductTree {
+    FieldContext ctx;
+    vector<uint64_t> points;
+    vector<vector<vector<uint64_t>>> levels;
+    vector<vector<vector<uint64_t>>> inverses;
+};
+
+// Below this many points a node is evaluated by Horner's rule.
+const size_t SUBPRODUCT_LEAF = 128;
+
+SubproductTree makeSubproductTree(const vector<uint64_t>& points,
+                                  const FieldContext& ctx) {
+    SubproductTree tree{ctx, points, {}, {}};
+    vector<vector<uint64_t>> level;
+    for (uint64_t u : points) {
+        level.push_back({u, 1});
+    }
+    tree.levels.push_back(level);
+    while (tree.levels.back().size() > 1) {
+        const vector<vector<uint64_t>>& below = tree.levels.back();
+        vector<vector<uint64_t>> above((below.size() + 1) / 2);
+        for (size_t j = 0; j < above.size(); j++) {
+            above[j] = 2 * j + 1 < below.size()
+                           ? mulFieldPoly(below[2 * j], below[2 * j + 1], ctx)
+                           : below[2 * j];
+        }
+        tree.levels.push_back(above);
+    }
+    // A node's remainder is taken of its parent's, of degree below twice
+    // its own; only nodes under ones too big for Horner's rule need it. The
+    // root's, for polynomials longer than itself, is found when needed.
+    for (size_t l = 0; l < tree.levels.size(); l++) {
+        vector<vector<uint64_t>> inverses(tree.levels[l].size());
+        if (((size_t)1 << l) >= SUBPRODUCT_LEAF &&
+            l + 1 < tree.levels.size()) {
+            for (size_t j = 0; j < inverses.size(); j++) {
+                const vector<uint64_t>& node = tree.levels[l][j];
+                inverses[j] = inverseSeries(
+                    vector<uint64_t>(node.rbegin(), node.rend()),
+                    node.size() - 1, ctx);
+            }
+        }
+        tree.inverses.push_back(inverses);
+    }
+    return tree;
+}
+
+// f at every point of the tree, by reducing f down the tree.
+vector<uint64_t> multipointEval(const SubproductTree& tree,
+                                const vector<uint64_t>& f) {
+    vector<uint64_t> res(tree.points.size());
+    if (res.empty()) {
+        return res;
+    }
+    function<void(int, size_t, const vector<uint64_t>&)> descend =
+        [&](int l, size_t j, const vector<uint64_t>& g) {
+            size_t from = j << l;
+            size_t to = min(from + ((size_t)1 << l), res.size());
+            if (to - from <= SUBPRODUCT_LEAF) {
+                vector<uint64_t> points(tree.points.begin() + from,
+                                        tree.points.begin() + to);
+                vector<uint64_t> values = hornerEval(g, points, tree.ctx);
+                copy(values.begin(), values.end(), res.begin() + from);
+                return;
+            }
+            for (size_t c = 2 * j; c < min(2 * j + 2,
+                                           tree.levels[l - 1].size());
+                 c++) {
+                descend(l - 1, c,
+                        modFieldPoly(g, tree.levels[l - 1][c],
+                                     tree.inverses[l - 1][c], tree.ctx));
+            }
+        };
+    int top = tree.levels.size() - 1;
+    descend(top, 0,
+            modFieldPoly(f, tree.levels[top][0], tree.inverses[top][0],
+                         tree.ctx));
+    return res;
+}
+
+// The polynomial of degree below n through (u_i, values[i]). By Lagrange
+// it is the sum of values[i] / M'(u_i) times M / (x + u_i), M being the
+// root; M'(u_i) comes from one multipoint evaluation, and the sum is
+// combined up the tree as left * right node + right * left node. Empty if
+// there is not one value per point or the points are not distinct, which
+// makes some M'(u_i) zero.
+vector<uint64_t> interpolate(const SubproductTree& tree,
+                             const vector<uint64_t>& values) {
+    if (values.empty() || values.size() != tree.points.size()) {
+        return {};
+    }
+    const FieldContext& ctx = tree.ctx;
+    const vector<uint64_t>& root = tree.levels.back()[0];
+    vector<uint64_t> derivative(root.size() - 1);
+    for (size_t i = 1; i < root.size(); i += 2) {
+        derivative[i - 1] = root[i];
+    }
+    vector<uint64_t> weights = multipointEval(tree, derivative);
+    if (count(weights.begin(), weights.end(), 0) != 0) {
+        return {};
+    }
+
+    vector<vector<uint64_t>> level(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        level[i] = {mulMod(values[i], inverse(weights[i], ctx), ctx)};
+    }
+    for (size_t l = 0; level.size() > 1; l++) {
+        const vector<vector<uint64_t>>& nodes = tree.levels[l];
+        vector<vector<uint64_t>> above((level.size() + 1) / 2);
+        for (size_t j = 0; j < above.size(); j++) {
+            if (2 * j + 1 == level.size()) {
+                above[j] = level[2 * j];
+                continue;
+            }
+            above[j] = mulFieldPoly(level[2 * j], nodes[2 * j + 1], ctx);
+            vector<uint64_t> right =
+                mulFieldPoly(level[2 * j + 1], nodes[2 * j], ctx);
+            above[j].resize(max(above[j].size(), right.size()));
+            for (size_t i = 0; i < right.size(); i++) {
+                above[j][i] ^= right[i];
+            }
+        }
+        level = above;
+    }
+    vector<uint64_t> res = level[0];
+    res.resize(values.size());
+    return res;
+}
+
+// GF(2)[x] products of huge operands through the additive FFT, as in
+// Cantor's method. The operands are cut into 32-bit chunks, making them
+// polynomials in y = x^32 over GF(2)[x]. A chunk is taken as an element of
+// GF(2^63) = GF(2)[x] / (x^63 + x + 1), where a product of two chunks, of
+// degree at most 62, is never reduced, nor is a sum of them; so one
+// product over GF(2^63) by FFT gives the chunk products, which are added
+// back 32 bits apart.
+
+const FieldContext& gf2FftField() {
+    static const FieldContext ctx =
+        makeFieldContext(Polynomial((1ULL << 63) | 0b11));
+    return ctx;
+}
+
+// A plan takes about 40 * 2^m bytes. Those up to this size are kept for
+// later products; bigger ones, which cost little next to their transforms,
+// are made for each product and freed with it.
+const int GF2_FFT_CACHED_PLAN = 18;
+
+// The plan for the subspace of the first 2^m elements.
+shared_ptr<const AdditiveFft> gf2FftPlan(int m) {
+    auto make = [m] {
+        return make_shared<const AdditiveFft>(
+            makeAdditiveFft(m, 0, standardBasis(m), gf2FftField()));
+    };
+    if (m > GF2_FFT_CACHED_PLAN) {
+        return make();
+    }
+    static mutex lock;
+    static vector<shared_ptr<const AdditiveFft>> plans(
+        GF2_FFT_CACHED_PLAN + 1);
+    lock_guard<mutex> guard(lock);
+    if (!plans[m]) {
+        plans[m] = make();
+    }
+    return plans[m];
+}
+
+void mulFft(const BigPolynomial& a, const BigPolynomial& b,
+            BigPolynomial& out) {
+    if (isZero(a) || isZero(b)) {
+        out.words.clear();
+        return;
+    }
+    size_t an = 2 * a.words.size(), bn = 2 * b.words.size();
+    int m = 0;
+    while (((size_t)1 << m) < an + bn - 1) {
+        m++;
+    }
+    shared_ptr<const AdditiveFft> plan = gf2FftPlan(m);
+    size_t size = (size_t)1 << m;
+    vector<uint64_t> x(size), y(size);
+    for (size_t i = 0; i < an; i++) {
+        x[i] = (uint32_t)(a.words[i / 2] >> (32 * (i % 2)));
+    }
+    for (size_t i = 0; i < bn; i++) {
+        y[i] = (uint32_t)(b.words[i / 2] >> (32 * (i % 2)));
+    }
+    // The two forward transforms are independent.
+    threadPool().invoke({[&] { additiveFft(*plan, x); },
+                         [&] { additiveFft(*plan, y); }});
+    mulMod(x, y, x, gf2FftField());
+    additiveIfft(*plan, x);
+
+    out.words.assign(a.words.size() + b.words.size() + 1, 0);
+    for (size_t k = 0; k < an + bn - 1; k++) {
+        out.words[k / 2] ^= x[k] << (32 * (k % 2));
+        if (k % 2 == 1) {
+            out.words[k / 2 + 1] ^= x[k] >> 32;
+        }
+    }
+    trim(out);
+}
+
+BigPolynomial operator>>(const BigPolynomial& a, int shift) {
+    size_t wordShift = shift / WORD_BITS;
+    int bitShift = shift % WORD_BITS;
+    if (wordShift >= a.words.size()) {
+        return {};
+    }
+
+    BigPolynomial res;
+    res.words.assign(a.words.size() - wordShift, 0);
+    for (size_t i = 0; i < res.words.size(); i++) {
+        res.words[i] = a.words[i + wordShift] >> bitShift;
+        if (bitShift != 0 && i + wordShift + 1 < a.words.size()) {
+            res.words[i] |= a.words[i + wordShift + 1]
+                            << (WORD_BITS - bitShift);
+        }
+    }
+    trim(res);
+    return res;
+}
+
+// a mod x^k
+BigPolynomial lowBits(const BigPolynomial& a, size_t k) {
+    size_t words = (k + WORD_BITS - 1) / WORD_BITS;
+    BigPolynomial res;
+    res.words.assign(a.words.begin(),
+                     a.words.begin() + min(words, a.words.size()));
+    if (k % WORD_BITS != 0 && res.words.size() == words) {
+        res.words.back() &= (1ULL << (k % WORD_BITS)) - 1;
+    }
+    trim(res);
+    return res;
+}
+
+// x^(length - 1) a(1 / x), for a of degree below length
+BigPolynomial reversed(const BigPolynomial& a, size_t length) {
+    size_t words = (length + WORD_BITS - 1) / WORD_BITS;
+    BigPolynomial res;
+    res.words.assign(words, 0);
+    for (size_t i = 0; i < min(words, a.words.size()); i++) {
+        res.words[words - 1 - i] = reverseBits(a.words[i]);
+    }
+    return res >> (words * WORD_BITS - length);
+}
+
+// 1 / f mod x^k for f(0) = 1, by Newton's iteration g <- f g^2.
+BigPolynomial inverseSeries(const BigPolynomial& f, size_t k) {
+    BigPolynomial g = fromExponents({0});
+    for (size_t precision = 1; precision < k;) {
+        precision = min(2 * precision, k);
+        g = lowBits(lowBits(f, precision) * square(g), precision);
+    }
+    return g;
+}
+
+// A dense modulus with 1 / rev(p) mod x^n, n = deg p, for reduction by two
+// multiplications (Barrett): for a of degree below 2n the quotient is
+// rev(rev(a) / rev(p) mod x^(deg a - n + 1)). Once products go through
+// Karatsuba or the FFT this beats reduceInPlace, which is quadratic.
+struct BarrettModulus {
+    BigPolynomial p;
+    BigPolynomial reversedInverse;
+};
+
+BarrettModulus makeBarrettModulus(const BigPolynomial& p) {
+    int n = degree(p);
+    return {p, inverseSeries(reversed(p, n + 1), n)};
+}
+
+bool isZero(const BarrettModulus& p) { return isZero(p.p); }
+
+int degree(const BarrettModulus& p) { return degree(p.p); }
+
+const BigPolynomial& toDense(const BarrettModulus& p) { return p.p; }
+
+// a = a mod p. Longer a is reduced from the top, 2n bits at a time.
+void reduceInPlace(BigPolynomial& a, const BarrettModulus& p) {
+    int n = degree(p);
+    if (n == 0) {
+        a.words.clear();
+        return;
+    }
+    while (!isZero(a) && degree(a) >= n) {
+        int shift = max(0, degree(a) - (2 * n - 1));
+        BigPolynomial high = a >> shift;
+        size_t k = degree(high) - n + 1;
+        BigPolynomial quotient = reversed(
+            lowBits(reversed(high >> n, k) * lowBits(p.reversedInverse, k),
+                    k),
+            k);
+        high = high + quotient * p.p;
+        a = lowBits(a, shift) + (high << shift);
+    }
+}
+
+BigPolynomial operator%(const BigPolynomial& a, const BarrettModulus& p) {
+    BigPolynomial rem = a;
+    reduceInPlace(rem, p);
+    return rem;
+}
+
+void prettyPrint(const Polynomial& a, int deg = -1) {
+    if (deg == -1) {
+        deg = degree(a);
+    }
+    for (int i = 0; i <= deg; i++) {
+        cout << a[i];
+    }
+    cout << '\n';
+}
+
+void prettyPrint(const vector<Polynomial>& polynomials) {
+    if (polynomials.empty()) {
+        return;
+    }
+    int maxDegree = degree(polynomials[0]);
+    for (const Polynomial& i : polynomials) {
+        maxDegree = max(maxDegree, degree(i));
+    }
+
+    for (const Polynomial& i : polynomials) {
+        prettyPrint(i, maxDegree);
+    }
+}
+
+// The polynomial p is assumed to be primitive
+void printField(const Polynomial& p) {
+    vector<Polynomial> field = findFieldElements(p);
+
+    cout << "Field size: " << field.size() << '\n';
+    cout << "Field elements:\n";
+    cout << "----------------------------------\n";
+    prettyPrint(field);
+    cout << "----------------------------------\n";
+}
+
+void runApplication(vector<Polynomial>& candidates) {
+    bool found = false;
+    for (Polynomial& p : candidates) {
+        if (!isPrimitive(p)) {
+            continue;
+        }
+
+        found = true;
+        cout << "Found primitive polynomial: ";
+        prettyPrint(p);
+        printField(p);
+        break;
+    }
+
+    if (!found) {
+        cout << "None of the candidate polynomials are primitive.\n";
+    }
+}
+
+void runTrinomialSearch(int n) {
+    bool mersenne = find(MERSENNE_EXPONENTS.begin(), MERSENNE_EXPONENTS.end(),
+                         n) != MERSENNE_EXPONENTS.end();
+    string checkpoint = "trinomials_" + to_string(n) + ".checkpoint";
+    cout << "Searching trinomials x^" << n
+         << " + x^k + 1, progress is saved to " << checkpoint << '\n';
+
+    vector<int> found = searchTrinomials(n, checkpoint);
+    for (int k : found) {
+        cout << "Found " << (mersenne ? "primitive" : "irreducible")
+             << " trinomials: x^" << n << " + x^" << k << " + 1 and x^" << n
+             << " + x^" << n - k << " + 1\n";
+    }
+    if (found.empty()) {
+        cout << "No irreducible trinomials of degree " << n << ".\n";
+    }
+}
+
+void testRemainder() {
+    cout << "Remainder tests:\n";
+    cout << (Polynomial(0b11111101111110) % Polynomial(0b100011011) ==
+             Polynomial(1));
+    cout << '\n';
+}
+
+void testAddition() {
+    cout << "Addition tests:\n";
+    cout << (Polynomial(0b101) + Polynomial(0b11) == Polynomial(0b110));
+    cout << (Polynomial(0) + Polynomial(0b11011) == Polynomial(0b11011));
+    cout << '\n';
+}
+
+void testMultiplication() {
+    cout << "Multiplication tests:\n";
+    Polynomial p1(0b101);
+    Polynomial p2(0b11);
+    Polynomial p3(0);
+
+    cout << (p1 * p2 == Polynomial(0b1111));
+    cout << (p2 * p2 == Polynomial(0b101));
+    cout << (p1 * p3 == p3);
+
+    cout << '\n';
+}
+
+void testFindFieldElements() {
+    Polynomial a(0b11001);
+    vector<Polynomial> elements = findFieldElements(Polynomial(0b11001));
+    prettyPrint(elements);
+
+    cout << isPrimitive(a) << '\n';
+}
+
+void testApplication() {
+    vector<Polynomial> candidates{Polynomial("1000001"), Polynomial("1001001"),
+                                  Polynomial("1100001")};
+    runApplication(candidates);
+}
+
+void testCanonicalCandidates() {
+    cout << "Canonical candidate tests:\n";
+    cout << (reciprocal(Polynomial(0b10011)) == Polynomial(0b11001));
+    cout << (lyndonWords(4).size() == 3);
+    cout << (necklace(0b1010, 4) == 0b0101);
+
+    for (int deg = 2; deg <= 10; deg++) {
+        vector<pair<Polynomial, Polynomial>> swept =
+            findPrimitivePolynomials(deg);
+        vector<pair<Polynomial, Polynomial>> derived =
+            primitivePolynomialsFromLyndonWords(swept[0].first);
+
+        int total = 0;
+        bool pairsValid = true;
+        for (const pair<Polynomial, Polynomial>& i : swept) {
+            total += (i.first == i.second) ? 1 : 2;
+            pairsValid = pairsValid && isPrimitive(i.second) &&
+                         reciprocal(i.first) == i.second;
+        }
+
+        int expected = 0;
+        for (uint64_t i = (1ULL << deg) + 1; i < (2ULL << deg); i += 2) {
+            expected += isPrimitive(Polynomial(i));
+        }
+
+        bool sameClasses = swept.size() == derived.size();
+        for (const pair<Polynomial, Polynomial>& i : derived) {
+            bool found = false;
+            for (const pair<Polynomial, Polynomial>& j : swept) {
+                found = found || i.first == j.first || i.first == j.second;
+            }
+            sameClasses = sameClasses && found;
+        }
+
+        cout << (pairsValid && total == expected && sameClasses);
+    }
+    cout << '\n';
+}
+
+void testBigPolynomials() {
+    cout << "Big polynomial tests:\n";
+    mt19937_64 rng(77);
+    BigPolynomial a, b, c;
+    for (int i = 0; i < 40; i++) {
+        a.words.push_back(rng());
+        b.words.push_back(rng());
+        c.words.push_back(rng());
+    }
+
+    BigPolynomial schoolbook;
+    schoolbook.words.assign(80, 0);
+    mulSchoolbook(a.words.data(), 40, b.words.data(), 40,
+                  schoolbook.words.data());
+    trim(schoolbook);
+    cout << (a * b == schoolbook);
+    cout << (a * (b + c) == a * b + a * c);
+    cout << (square(a) == a * a);
+    cout << (toBigPolynomial(Polynomial(0b11111101111110)) %
+                 toBigPolynomial(Polynomial(0b100011011)) ==
+             fromExponents({0}));
+
+    BigPolynomial p = fromExponents({521, 32, 0});
+    BigPolynomial g = a % p;
+    BigPolynomial h = b % p;
+    BigPolynomial horner;
+    for (int i = degree(g); i >= 0; i--) {
+        horner = mulMod(horner, h, p);
+        if ((g.words[i / WORD_BITS] >> (i % WORD_BITS)) & 1) {
+            horner = horner + fromExponents({0});
+        }
+    }
+    cout << (composeMod(g, h, p) == horner);
+
+    BigPolynomial squarings = fromExponents({1});
+    for (int i = 0; i < 300; i++) {
+        squarings = squareMod(squarings, p);
+    }
+    cout << (frobeniusPower(300, p) == squarings);
+
+    cout << isIrreducible(fromExponents({127, 1, 0}));
+    cout << isIrreducible(fromExponents({521, 32, 0}));
+    cout << isIrreducible(fromExponents({607, 105, 0}));
+    cout << !isIrreducible(fromExponents({127, 1, 0}) *
+                           fromExponents({89, 38, 0}));
+
+    // Numbers of irreducible polynomials of degrees 1 to 8.
+    vector<int> expected = {2, 1, 2, 3, 6, 9, 18, 30};
+    for (int deg = 1; deg <= 8; deg++) {
+        int count = 0;
+        for (uint64_t i = 1ULL << deg; i < (2ULL << deg); i++) {
+            count += isIrreducible(toBigPolynomial(Polynomial(i)));
+        }
+        cout << (count == expected[deg - 1]);
+    }
+    cout << '\n';
+}
+
+void testTrinomialSearch() {
+    cout << "Trinomial search tests:\n";
+    for (int n = 3; n <= 40; n++) {
+        bool consistent = true;
+        for (int k = 1; k < n; k++) {
+            bool irreducible = isIrreducible(fromExponents({n, k, 0}));
+            consistent = consistent && !(swanReducible(n, k) && irreducible) &&
+                         (n % 2 == 1 || k % 2 == 1 || swanReducible(n, k));
+        }
+        cout << consistent;
+    }
+
+    for (int n : {89, 127, 131}) {
+        vector<int> expected;
+        for (int k = 1; k <= n / 2; k++) {
+            if (isIrreducible(fromExponents({n, k, 0}))) {
+                expected.push_back(k);
+            }
+        }
+        cout << (searchTrinomials(n) == expected);
+    }
+
+    string checkpoint =
+        (filesystem::temp_directory_path() / "trinomials_test.checkpoint")
+            .string();
+    filesystem::remove(checkpoint);
+    vector<int> first = searchTrinomials(521, checkpoint);
+    vector<int> resumed = searchTrinomials(521, checkpoint);
+    filesystem::remove(checkpoint);
+    cout << (first == resumed && first == vector<int>{32, 48, 158, 168});
+    cout << '\n';
+}
+
+void testJumpPolynomials() {
+    cout << "Jump polynomial tests:\n";
+    mt19937_64 rng(79);
+    vector<uint8_t> lfsr(254);
+    for (int i = 0; i < 127; i++) {
+        lfsr[i] = rng() & 1;
+    }
+    for (int i = 127; i < 254; i++) {
+        lfsr[i] = lfsr[i - 127] ^ lfsr[i - 126];
+    }
+    cout << (berlekampMassey(lfsr) == fromExponents({127, 1, 0}));
+
+    Mt19937 generator(2024);
+    mt19937 reference(2024);
+    bool sameOutputs = true;
+    for (int i = 0; i < 1000; i++) {
+        sameOutputs = sameOutputs && generator.next() == reference();
+    }
+    cout << sameOutputs;
+
+    BigPolynomial charPoly = berlekampMassey(outputBits(generator, 19937));
+    cout << (degree(charPoly) == 19937);
+
+    const unsigned long long steps = 100000;
+    BigPolynomial jumpPoly = jumpPolynomial(steps, charPoly);
+    vector<Mt19937> streams = jumpStreams(generator, 3, jumpPoly);
+    Mt19937 stepped = generator;
+    bool sameStreams = true;
+    for (int stream = 1; stream < 3; stream++) {
+        for (unsigned long long i = 0; i < steps; i++) {
+            stepped.next();
+        }
+        Mt19937 copy = stepped;
+        for (int i = 0; i < 10; i++) {
+            sameStreams = sameStreams && streams[stream].next() == copy.next();
+        }
+    }
+    cout << sameStreams;
+    cout << '\n';
+}
+
+void testSparsePolynomials() {
+    cout << "Sparse polynomial tests:\n";
+    mt19937_64 rng(80);
+    BigPolynomial a, b;
+    for (int i = 0; i < 45; i++) {
+        a.words.push_back(rng());
+        b.words.push_back(rng());
+    }
+
+    SparsePolynomial trinomial{{1279, 418, 0}};
+    SparsePolynomial pentanomial{{163, 7, 6, 3, 0}};
+    SparsePolynomial sparse{{700, 333, 64, 5}};
+    cout << (degree(trinomial) == 1279);
+    cout << (toSparse(toDense(pentanomial)) == pentanomial);
+    cout << (sparse * a == toDense(sparse) * a);
+    BigPolynomial denseSparse = toDense(sparse);
+    cout << (toDense(sparse * trinomial) == denseSparse * toDense(trinomial));
+    cout << (toDense(sparse + trinomial) == denseSparse + toDense(trinomial));
+    cout << ((a * b) % trinomial == (a * b) % toDense(trinomial));
+    cout << ((a * b) % pentanomial == (a * b) % toDense(pentanomial));
+    cout << (frobeniusPower(1000, trinomial) ==
+             frobeniusPower(1000, toDense(trinomial)));
+    cout << isIrreducible(trinomial);
+    cout << isIrreducible(pentanomial);
+    cout << !isIrreducible(sparse * trinomial);
+    cout << '\n';
+}
+
+void testSmallPolynomials() {
+    cout << "Small polynomial tests:\n";
+    using Byte = SmallPolynomialFor<7>;
+    using Word = SmallPolynomialFor<63>;
+    using Wide = SmallPolynomialFor<127>;
+    cout << is_same<Byte, SmallPolynomial<uint8_t>>::value;
+    cout << is_same<SmallPolynomialFor<8>, SmallPolynomial<uint16_t>>::value;
+
+    mt19937_64 rng(81);
+    bool sameAsBitset = true;
+    for (int i = 0; i < 1000; i++) {
+        Polynomial a(rng()), b(rng() >> (rng() % 64));
+        Word smallA = toSmallPolynomial<uint64_t>(a);
+        Word smallB = toSmallPolynomial<uint64_t>(b);
+        sameAsBitset = sameAsBitset && toPolynomial(smallA * smallB) == a * b &&
+                       toPolynomial(smallA + smallB) == a + b &&
+                       degree(smallA) == degree(a);
+        if (degree(b) > 0) {
+            sameAsBitset =
+                sameAsBitset && toPolynomial(smallA % smallB) == a % b;
+        }
+    }
+    cout << sameAsBitset;
+
+    Wide wideA{((unsigned __int128)1 << 100) | 1};
+    Wide wideB{((unsigned __int128)1 << 27) | 1};
+    cout << (degree(wideA * wideB) == 127);
+
+    SmallPolynomialFor<8> p{0x11D};
+    vector<Polynomial> field = findFieldElements(Polynomial(0x11D));
+    vector<SmallPolynomial<uint16_t>> smallField = findFieldElements(p);
+    bool sameField = field.size() == smallField.size();
+    for (size_t i = 0; sameField && i < field.size(); i++) {
+        sameField = field[i] == toPolynomial(smallField[i]);
+    }
+    cout << sameField;
+
+    bool samePrimitive = true;
+    for (int i = 0x81; i < 0x100; i += 2) {
+        Byte small{(uint8_t)i};
+        samePrimitive =
+            samePrimitive && isPrimitive(small) == isPrimitive(Polynomial(i));
+    }
+    cout << samePrimitive;
+
+    // Past the widths a walk through the group could handle
+    using Wide = SmallPolynomial<unsigned __int128>;
+    unsigned __int128 x64 = (unsigned __int128)1 << 64;
+    cout << (isPrimitive(SmallPolynomial<uint64_t>{(1ULL << 63) | 0b11}) &&
+             isPrimitive(Wide{x64 | 0b11011}) && !isPrimitive(Wide{x64 | 1}) &&
+             !isPrimitive(Byte{0x1F}));
+
+    // Orders beyond 64 bits, with 2^122 - 1 needing its cyclotomic split
+    auto x = [](int k) { return (unsigned __int128)1 << k; };
+    cout << (isPrimitive(Wide{x(127) | x(1) | 1}) &&
+             isPrimitive(Wide{x(122) | x(121) | x(63) | x(62) | 1}) &&
+             isPrimitive(Wide{x(65) | x(18) | 1}) &&
+             !isPrimitive(Wide{x(127) | 1}) &&
+             !isPrimitive(Wide{x(122) | x(121) | x(63) | 1}));
+    cout << '\n';
+}
+
+void testFieldContext() {
+    cout << "Field context tests:\n";
+    mt19937_64 rng(82);
+    vector<Polynomial> moduli = {Polynomial(0b111), Polynomial(0x11D),
+                                 Polynomial(0x1100B), Polynomial(0x1000000AF),
+                                 Polynomial((1ULL << 53) | 0b1000111),
+                                 Polynomial((1ULL << 63) | 0b11)};
+    for (const Polynomial& p : moduli) {
+        FieldContext ctx = makeFieldContext(p);
+        vector<uint64_t> a(1001), b(1001), out;
+        for (size_t i = 0; i < a.size(); i++) {
+            a[i] = rng() & ctx.mask;
+            b[i] = rng() & ctx.mask;
+        }
+        mulMod(a, b, out, ctx);
+
+        bool correct = out.size() == a.size();
+        for (size_t i = 0; i < a.size(); i++) {
+            BigPolynomial expected =
+                mulMod(toBigPolynomial(Polynomial(a[i])),
+                       toBigPolynomial(Polynomial(b[i])), toBigPolynomial(p));
+            correct =
+                correct && toBigPolynomial(Polynomial(out[i])) == expected;
+        }
+        cout << correct;
+    }
+    cout << '\n';
+}
+
+void testBitslicing() {
+    cout << "Bitsliced arithmetic tests:\n";
+    mt19937_64 rng(83);
+    for (const Polynomial& p : {Polynomial(0b10011), Polynomial(0x11D)}) {
+        FieldContext ctx = makeFieldContext(p);
+        BitslicedCircuit circuit = makeBitslicedCircuit(p);
+        vector<uint8_t> a(1000), b(1000), product, inverses;
+        for (size_t i = 0; i < a.size(); i++) {
+            a[i] = rng() & ctx.mask;
+            b[i] = rng() & ctx.mask;
+        }
+
+        mulBitsliced(a, b, product, circuit);
+        invertBitsliced(a, inverses, circuit);
+        bool correct = true;
+        for (size_t i = 0; i < a.size(); i++) {
+            correct = correct && product[i] == mulMod(a[i], b[i], ctx);
+            uint64_t one = mulMod(a[i], inverses[i], ctx);
+            correct = correct && (a[i] == 0 ? inverses[i] == 0 : one == 1);
+        }
+        cout << correct;
+    }
+
+    // Degrees beyond the 8 slices of a batch are refused
+    vector<uint8_t> a(100, 1), out(100);
+    BitslicedCircuit tooWide = makeBitslicedCircuit(Polynomial(0x1100B));
+    cout << (tooWide.deg == 0 && !mulBitsliced(a, a, out, tooWide) &&
+             out.empty() && !invertBitsliced(a, out, tooWide) &&
+             makeBitslicedCircuit(Polynomial(1)).deg == 0 &&
+             makeBitslicedCircuit(Polynomial(0x3)).deg == 1)
+         << '\n';
+}
+
+void testTransposes() {
+    cout << "Transpose tests:\n";
+    mt19937_64 rng(84);
+
+    vector<uint64_t> small(19), smallT(19);
+    for (uint64_t& m : small) {
+        m = rng();
+    }
+    transpose8x8(small.data(), smallT.data(), small.size());
+    bool correct8 = true;
+    for (size_t k = 0; k < small.size(); k++) {
+        for (int i = 0; i < 8; i++) {
+            for (int j = 0; j < 8; j++) {
+                correct8 = correct8 && ((small[k] >> (8 * i + j)) & 1) ==
+                                           ((smallT[k] >> (8 * j + i)) & 1);
+            }
+        }
+    }
+    cout << correct8;
+
+    uint64_t block[64], original[64];
+    for (int i = 0; i < 64; i++) {
+        original[i] = block[i] = rng();
+    }
+    transpose64x64(block);
+    bool correct64 = true;
+    for (int i = 0; i < 64; i++) {
+        for (int j = 0; j < 64; j++) {
+            correct64 = correct64 &&
+                        ((original[i] >> j) & 1) == ((block[j] >> i) & 1);
+        }
+    }
+    cout << correct64;
+
+    int rows = 150, cols = 100;
+    vector<uint64_t> m((size_t)rows * 2);
+    for (int i = 0; i < rows; i++) {
+        m[2 * i] = rng();
+        m[2 * i + 1] = rng() & ((1ULL << (cols - 64)) - 1);
+    }
+    vector<uint64_t> t = transposeBitMatrix(m, rows, cols);
+    bool correct = t.size() == (size_t)cols * 3;
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            correct = correct && ((m[2 * i + j / 64] >> (j % 64)) & 1) ==
+                                     ((t[3 * j + i / 64] >> (i % 64)) & 1);
+        }
+    }
+    cout << (correct && transposeBitMatrix(t, cols, rows) == m);
+    cout << '\n';
+}
+
+void testBranchFree() {
+    cout << "Branch-free tests:\n";
+    mt19937_64 rng(85);
+    bool sameAsBranching = true;
+    for (int i = 0; i < 1000; i++) {
+        Polynomial a(rng()), b((rng() >> (rng() % 63)) | 0b10);
+        sameAsBranching = sameAsBranching && mulBranchFree(a, b) == a * b &&
+                          remBranchFree(a, b) == a % b;
+    }
+    cout << sameAsBranching;
+
+    for (const Polynomial& p : {Polynomial(0x11D), Polynomial(0x1000000AF)}) {
+        FieldContext fast = makeFieldContext(p);
+        FieldContext constantTime = makeFieldContext(p, true);
+        bool correct = inverse(0, fast) == 0 && inverse(0, constantTime) == 0;
+        for (int i = 0; i < 1000; i++) {
+            uint64_t a = (rng() & fast.mask) | 1;
+            uint64_t e = rng();
+            correct = correct && mulMod(a, inverse(a, fast), fast) == 1 &&
+                      inverse(a, constantTime) == inverse(a, fast) &&
+                      power(a, e, constantTime) == power(a, e, fast);
+            // The context picks the kernels for Polynomial elements
+            Polynomial x(a), y(e & fast.mask);
+            correct = correct &&
+                      mulMod(x, y, constantTime) == mulMod(x, y, fast) &&
+                      mulMod(x, y, fast).to_ullong() ==
+                          mulMod(a, e & fast.mask, fast);
+        }
+        cout << correct;
+    }
+
+    // A reducible modulus is detected, and Euclid still stops on it
+    FieldContext reducible = makeFieldContext(Polynomial(0x101));
+    cout << (!isIrreducible(reducible) &&
+             isIrreducible(makeFieldContext(Polynomial(0x11D))) &&
+             inverse(0b11, reducible) == 0 &&
+             mulMod(0b10, inverse(0b10, reducible), reducible) == 1)
+         << '\n';
+}
+
+void testThreadPool() {
+    cout << "Thread pool tests:\n";
+    ThreadPool pool(4);
+    vector<int> hits(100000);
+    pool.parallelFor(
+        0, hits.size(),
+        [&](size_t from, size_t to) {
+            for (size_t i = from; i < to; i++) {
+                hits[i]++;
+            }
+        },
+        100);
+    cout << all_of(hits.begin(), hits.end(), [](int h) { return h == 1; });
+
+    // Nested loops run on the same workers
+    atomic<size_t> total{0};
+    pool.parallelFor(0, 8, [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; i++) {
+            pool.parallelFor(
+                0, 1000, [&](size_t f, size_t t) { total += t - f; }, 10);
+        }
+    });
+    cout << (total == 8000);
+
+    TaskGroup group;
+    atomic<int> done{0};
+    for (int i = 0; i < 100; i++) {
+        pool.submit(group, [&done] { done++; });
+    }
+    pool.wait(group);
+    cout << (done == 100);
+
+    // An exception from a task reaches the waiting caller, after the other
+    // tasks, and the pool keeps working
+    atomic<size_t> covered{0};
+    bool caught = false;
+    try {
+        pool.parallelFor(
+            0, 1000,
+            [&](size_t from, size_t to) {
+                covered += to - from;
+                if (from <= 500 && 500 < to) {
+                    throw runtime_error("task failed");
+                }
+            },
+            10);
+    } catch (const runtime_error&) {
+        caught = true;
+    }
+    bool rethrown = false;
+    try {
+        pool.invoke({[] {}, [] { throw bad_alloc(); }});
+    } catch (const bad_alloc&) {
+        rethrown = true;
+    }
+    total = 0;
+    pool.parallelFor(0, 1000, [&](size_t f, size_t t) { total += t - f; }, 10);
+    cout << (caught && rethrown && covered == 1000 && total == 1000);
+
+    mt19937_64 rng(86);
+    FieldContext ctx = makeFieldContext(Polynomial(0x100400007));
+    vector<uint64_t> a(100000), b(100000), out;
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = rng() & ctx.mask;
+        b[i] = rng() & ctx.mask;
+    }
+    mulMod(a, b, out, ctx);
+    bool correct = out.size() == a.size();
+    for (size_t i = 0; i < a.size() && correct; i++) {
+        correct = out[i] == mulMod(a[i], b[i], ctx);
+    }
+    cout << correct << '\n';
+}
+
+void testArena() {
+    cout << "Arena tests:\n";
+    mt19937_64 rng(87);
+    bool correct = true;
+    for (int words : {1, 5, 20, 70}) {
+        BigPolynomial a, b, p;
+        for (int i = 0; i < words; i++) {
+            a.words.push_back(rng());
+            b.words.push_back(rng() | 1);
+            p.words.push_back(rng());
+        }
+        p.words.back() |= 1ULL << 63;
+
+        // The product bit by bit, as a sum of shifted copies of a
+        BigPolynomial expected;
+        for (int i = 0; i <= degree(b); i++) {
+            if ((b.words[i / WORD_BITS] >> (i % WORD_BITS)) & 1) {
+                expected = expected + (a << i);
+            }
+        }
+        BigPolynomial product = a;
+        mulInto(product, b, product);
+        correct = correct && product == expected;
+
+        BigPolynomial rem = product;
+        reduceInPlace(rem, p);
+        correct = correct && degree(rem) < degree(p) &&
+                  (product + rem) % p == BigPolynomial() &&
+                  mulMod(a, b, p) == rem;
+    }
+    cout << correct;
+
+    // Scopes give the memory back and later scopes reuse it
+    Arena arena;
+    bool reused = true;
+    for (int i = 0; i < 3; i++) {
+        ArenaScope scope(arena);
+        uint64_t* first = arena.allocateWords(1000);
+        ArenaResource resource(arena);
+        pmr::vector<uint64_t> words(5000, 1, &resource);
+        reused = reused && arena.blocks.size() == 1 &&
+                 (i == 0 || first == (uint64_t*)arena.blocks[0].get()) &&
+                 words[4999] == 1;
+    }
+    cout << (reused && arena.block == 0 && arena.used == 0) << '\n';
+}
+
+void testLazyExpressions() {
+    cout << "Lazy expression tests:\n";
+    mt19937_64 rng(88);
+    FieldContext ctx = makeFieldContext(Polynomial(0x100400007));
+    bool correct = true;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t a = rng() & ctx.mask, b = rng() & ctx.mask;
+        uint64_t c = rng() & ctx.mask, d = rng() & ctx.mask;
+        correct = correct &&
+                  (lazy(a) * lazy(b) + lazy(c) * lazy(d)) % ctx ==
+                      (mulMod(a, b, ctx) ^ mulMod(c, d, ctx)) &&
+                  ((lazy(a) + lazy(b)) * lazy(c) + lazy(d)) % ctx ==
+                      (mulMod(a ^ b, c, ctx) ^ d) &&
+                  (lazy(a) + lazy(b)) % ctx == (a ^ b);
+    }
+    cout << correct << '\n';
+}
+
+void testLazyReduction() {
+    cout << "Lazy reduction tests:\n";
+    mt19937_64 rng(89);
+    bool correct = true;
+    for (const Polynomial& p : {Polynomial(0x11D), Polynomial(0x100400007)}) {
+        FieldContext ctx = makeFieldContext(p);
+        for (size_t count : {0, 1, 7, 8, 33, 200}) {
+            vector<uint64_t> a(count), b(count), points(count % 13);
+            for (size_t i = 0; i < count; i++) {
+                a[i] = rng() & ctx.mask;
+                b[i] = rng() & ctx.mask;
+            }
+            for (uint64_t& x : points) {
+                x = rng() & ctx.mask;
+            }
+
+            uint64_t expected = 0;
+            for (size_t i = 0; i < count; i++) {
+                expected ^= mulMod(a[i], b[i], ctx);
+            }
+            correct = correct && dot(a, b, ctx) == expected;
+
+            vector<uint64_t> values = hornerEval(a, points, ctx);
+            for (size_t j = 0; j < points.size(); j++) {
+                uint64_t value = 0;
+                for (size_t i = count; i-- > 0;) {
+                    value = mulMod(value, points[j], ctx) ^ a[i];
+                }
+                correct = correct && values[j] == value &&
+                          hornerEval(a, points[j], ctx) == value;
+            }
+        }
+    }
+    cout << correct << '\n';
+}
+
+void testFixedMultiplier() {
+    cout << "Fixed multiplier tests:\n";
+    mt19937_64 rng(90);
+    for (const Polynomial& p : {Polynomial(0x11D), Polynomial(0x100400007)}) {
+        bool correct = true;
+        for (bool constantTime : {false, true}) {
+            FieldContext ctx = makeFieldContext(p, constantTime);
+            for (int window : {4, 8}) {
+                uint64_t b = rng() & ctx.mask;
+                FixedMultiplier m = makeFixedMultiplier(b, ctx, window);
+                for (int i = 0; i < 200; i++) {
+                    uint64_t a = rng() & ctx.mask;
+                    correct = correct && multiply(m, a) == mulMod(a, b, ctx);
+                }
+            }
+        }
+        cout << correct;
+    }
+    cout << '\n';
+}
+
+void testChienSearch() {
+    cout << "Chien search tests:\n";
+    mt19937_64 rng(91);
+    for (const Polynomial& p : {Polynomial(0x11D), Polynomial(0x1100B)}) {
+        FieldContext ctx = makeFieldContext(p);
+        bool correct = true;
+        for (int count : {1, 5, 16, 40}) {
+            // locator = product of (x + alpha^i) over the chosen positions
+            vector<uint64_t> positions, locator = {1};
+            while ((int)positions.size() < count) {
+                uint64_t i = rng() % ctx.mask;
+                if (find(positions.begin(), positions.end(), i) ==
+                    positions.end()) {
+                    positions.push_back(i);
+                }
+            }
+            for (uint64_t i : positions) {
+                uint64_t root = power(2, i, ctx);
+                locator.push_back(0);
+                for (size_t j = locator.size() - 1; j > 0; j--) {
+                    locator[j] = locator[j - 1] ^ mulMod(locator[j], root, ctx);
+                }
+                locator[0] = mulMod(locator[0], root, ctx);
+            }
+            sort(positions.begin(), positions.end());
+            correct = correct && chienSearch(locator, ctx) == positions;
+        }
+
+        // Polynomials with fewer roots than their degree
+        for (int i = 0; i < 10 && ctx.deg == 8; i++) {
+            vector<uint64_t> locator(1 + rng() % 20);
+            for (uint64_t& c : locator) {
+                c = rng() & ctx.mask;
+            }
+            vector<uint64_t> expected;
+            for (uint64_t j = 0; j < ctx.mask; j++) {
+                if (hornerEval(locator, power(2, j, ctx), ctx) == 0) {
+                    expected.push_back(j);
+                }
+            }
+            vector<uint64_t> roots = chienSearch(locator, ctx);
+            correct = correct && (roots == expected || locator.size() == 1);
+        }
+        cout << correct;
+    }
+    cout << '\n';
+}
+
+void testSecretSharing() {
+    cout << "Secret sharing tests:\n";
+    mt19937_64 rng(92);
+    FieldContext ctx = makeFieldContext(Polynomial(0x11D));
+
+    bool regions = true;
+    for (size_t count : {1, 15, 16, 100, 1000}) {
+        vector<uint8_t> src(count), dst(count), expected(count);
+        for (size_t i = 0; i < count; i++) {
+            src[i] = rng();
+            dst[i] = rng();
+        }
+        uint8_t c = rng();
+        for (size_t i = 0; i < count; i++) {
+            expected[i] = dst[i] ^ mulMod(c, src[i], ctx);
+        }
+        mulAddRegion(dst.data(), src.data(), count, makeNibbleTables(c, ctx));
+        regions = regions && dst == expected;
+    }
+    cout << regions;
+
+    vector<uint8_t> secret(100000);
+    for (uint8_t& b : secret) {
+        b = rng();
+    }
+    bool recovered = true;
+    for (int k : {1, 3, 5}) {
+        vector<Share> shares = splitSecret(secret, 7, k, ctx);
+        for (int i = 0; i < 5; i++) {
+            shuffle(shares.begin(), shares.end(), rng);
+            vector<Share> subset(shares.begin(), shares.begin() + k + i % 2);
+            recovered = recovered && combineShares(subset, ctx) == secret;
+        }
+        if (k > 1) {
+            vector<Share> tooFew(shares.begin(), shares.begin() + k - 1);
+            recovered = recovered && combineShares(tooFew, ctx) != secret;
+        }
+    }
+    cout << recovered;
+
+    vector<Share> shares = splitSecret(secret, 3, 2, ctx);
+    vector<Share> repeated = {shares[0], shares[0]};
+    cout << (splitSecret(secret, 3, 4, ctx).empty() &&
+             splitSecret(secret, 256, 2, ctx).empty() &&
+             splitSecret(secret, 3, 2, makeFieldContext(Polynomial(0x13)))
+                 .empty() &&
+             combineShares(repeated, ctx).empty() &&
+             combineShares({}, ctx).empty());
+    // x^8 + 1 is of degree 8 but reducible
+    FieldContext reducible = makeFieldContext(Polynomial(0x101));
+    cout << (splitSecret(secret, 3, 2, reducible).empty() &&
+             combineShares(shares, reducible).empty())
+         << '\n';
+}
+
+void testCauchyCoding() {
+    cout << "Cauchy coding tests:\n";
+    mt19937_64 rng(93);
+    FieldContext ctx = makeFieldContext(Polynomial(0x11D));
+
+    // The inverse of a random matrix, when there is one
+    bool inverts = true;
+    for (int n : {1, 3, 8}) {
+        vector<uint64_t> a(n * n);
+        for (uint64_t& e : a) {
+            e = rng() & ctx.mask;
+        }
+        vector<uint64_t> b = invertMatrix(a, n, ctx);
+        for (int i = 0; i < n && !b.empty(); i++) {
+            for (int j = 0; j < n; j++) {
+                uint64_t sum = 0;
+                for (int t = 0; t < n; t++) {
+                    sum ^= mulMod(a[i * n + t], b[t * n + j], ctx);
+                }
+                inverts = inverts && sum == (uint64_t)(i == j);
+            }
+        }
+    }
+    cout << (inverts && invertMatrix({1, 2, 1, 2}, 2, ctx).empty());
+
+    // The XOR schedule computes the same as the bit matrix
+    const int k = 5, m = 3;
+    const size_t blockSize = 8 * 1000;
+    CauchyCode code = makeCauchyCode(k, m, ctx);
+    vector<vector<uint8_t>> storage(k + m, vector<uint8_t>(blockSize));
+    vector<uint8_t*> blocks;
+    for (vector<uint8_t>& block : storage) {
+        blocks.push_back(block.data());
+    }
+    for (int b = 0; b < k; b++) {
+        for (uint8_t& byte : storage[b]) {
+            byte = rng();
+        }
+    }
+    encode(code, vector<uint8_t*>(blocks.begin(), blocks.begin() + k),
+           vector<uint8_t*>(blocks.begin() + k, blocks.end()), blockSize);
+
+    vector<uint8_t> bits = toBitmatrix(code.matrix, m, k, ctx);
+    bool encodes = true;
+    size_t packetSize = blockSize / 8;
+    for (int r = 0; r < m * 8; r++) {
+        vector<uint8_t> expected(packetSize);
+        for (int c = 0; c < k * 8; c++) {
+            if (bits[r * k * 8 + c]) {
+                xorRegion(expected.data(),
+                          blocks[c / 8] + (c % 8) * packetSize, packetSize);
+            }
+        }
+        encodes = encodes &&
+                  equal(expected.begin(), expected.end(),
+                        blocks[k + r / 8] + (r % 8) * packetSize);
+    }
+    cout << encodes;
+
+    // Every pattern of up to m erasures is repaired
+    vector<vector<uint8_t>> original = storage;
+    bool repairs = true;
+    for (int pattern = 0; pattern < (1 << (k + m)); pattern++) {
+        vector<bool> erased(k + m);
+        for (int b = 0; b < k + m; b++) {
+            erased[b] = (pattern >> b) & 1;
+            if (erased[b]) {
+                fill(storage[b].begin(), storage[b].end(), 0);
+            }
+        }
+        bool decoded = decode(code, blocks, erased, blockSize);
+        if (__builtin_popcount(pattern) <= m) {
+            repairs = repairs && decoded && storage == original;
+        } else {
+            repairs = repairs && !decoded;
+        }
+        storage = original;
+    }
+    cout << repairs;
+
+    // The point search never does worse than the fixed points
+    bool searches = true;
+    for (FieldContext field : {ctx, makeFieldContext(Polynomial(0x13))}) {
+        for (int kk : {2, 5, 10}) {
+            for (int mm : {2, 3, 4}) {
+                if ((uint64_t)kk + mm > field.mask + 1) {
+                    continue;
+                }
+                vector<uint64_t> xs, ys;
+                for (int t = 0; t < kk + mm; t++) {
+                    (t < mm ? xs : ys).push_back(t);
+                }
+                int searched = 0, fixed = 0;
+                for (uint64_t e : cauchyMatrix(kk, mm, field)) {
+                    searched += bitmatrixOnes(e, field);
+                }
+                for (uint64_t e : cauchyMatrix(xs, ys, field)) {
+                    fixed += bitmatrixOnes(e, field);
+                }
+                searches = searches && searched <= fixed;
+            }
+        }
+    }
+    cout << searches;
+
+    // Too many blocks for distinct points, and packets of unequal size
+    FieldContext small = makeFieldContext(Polynomial(0x13));
+    CauchyCode tooLong = makeCauchyCode(10, 7, small);
+    vector<uint8_t*> data(blocks.begin(), blocks.begin() + k);
+    vector<uint8_t*> coding(blocks.begin() + k, blocks.end());
+    cout << (tooLong.matrix.empty() &&
+             !encode(tooLong, data, coding, blockSize) &&
+             makeCauchyCode(10, 6, small).matrix.size() == 10 * 6 &&
+             !encode(code, data, coding, blockSize - 1) &&
+             !decode(code, blocks, vector<bool>(k + m), blockSize - 1) &&
+             !decode(code, blocks, vector<bool>(k), blockSize))
+         << '\n';
+}
+
+void testLocalCodes() {
+    cout << "Locally repairable code tests:\n";
+    mt19937_64 rng(94);
+    FieldContext ctx = makeFieldContext(Polynomial(0x11D));
+    const int k = 6, groups = 2, globals = 2, n = k + groups + globals;
+    const size_t blockSize = 1000;
+    LocalCode code = makeLocalCode(k, groups, globals, ctx);
+    vector<vector<uint8_t>> storage(n, vector<uint8_t>(blockSize));
+    vector<uint8_t*> blocks;
+    for (vector<uint8_t>& block : storage) {
+        blocks.push_back(block.data());
+    }
+    for (int b = 0; b < k; b++) {
+        for (uint8_t& byte : storage[b]) {
+            byte = rng();
+        }
+    }
+    encode(code, blocks, blockSize);
+    vector<vector<uint8_t>> original = storage;
+
+    bool repairs = groupBlocks(code, 1) == vector<int>{3, 4, 5, 7};
+    for (int b = 0; b < n; b++) {
+        fill(storage[b].begin(), storage[b].end(), 0);
+        repairLocal(code, blocks, b, blockSize);
+        repairs = repairs && storage == original;
+    }
+    cout << repairs;
+
+    // Any globals + 1 erasures are decoded
+    bool decodes = true;
+    for (int pattern = 0; pattern < (1 << n); pattern++) {
+        if (__builtin_popcount(pattern) > globals + 1) {
+            continue;
+        }
+        vector<bool> erased(n);
+        for (int b = 0; b < n; b++) {
+            erased[b] = (pattern >> b) & 1;
+            if (erased[b]) {
+                fill(storage[b].begin(), storage[b].end(), 0);
+            }
+        }
+        decodes = decodes && decode(code, blocks, erased, blockSize) &&
+                  storage == original;
+        storage = original;
+    }
+
+    // A whole group with its parity and a global parity cannot be decoded
+    vector<bool> erased(n);
+    for (int b : {0, 1, 2, 6, 8}) {
+        erased[b] = true;
+    }
+    cout << (decodes && !decode(code, blocks, erased, blockSize) &&
+             !decode(code, blocks, vector<bool>(n - 1), blockSize));
+
+    // The GF(2^8) region kernels cannot serve another field
+    FieldContext wideField = makeFieldContext(Polynomial(0x1100B));
+    LocalCode wide = makeLocalCode(k, groups, globals, wideField);
+    cout << (wide.k == 0 && !encode(wide, blocks, blockSize) &&
+             !repairLocal(wide, blocks, 0, blockSize) &&
+             !decode(wide, blocks, vector<bool>(n), blockSize) &&
+             makeLocalCode(k, k + 1, globals, ctx).k == 0)
+         << '\n';
+}
+
+void testReedSolomon16() {
+    cout << "GF(2^16) Reed-Solomon tests:\n";
+    mt19937_64 rng(95);
+    FieldContext ctx = makeFieldContext(Polynomial(0x1100B));
+
+    bool regions = true;
+    for (int trial = 0; trial < 20; trial++) {
+        uint16_t c = rng();
+        vector<uint16_t> src(101), dst(101);
+        for (size_t i = 0; i < src.size(); i++) {
+            src[i] = rng();
+            dst[i] = rng();
+        }
+        vector<uint16_t> expected = dst;
+        for (size_t i = 0; i < src.size(); i++) {
+            expected[i] ^= mulMod(c, src[i], ctx);
+        }
+        mulAddRegion16(dst.data(), src.data(), src.size(),
+                       makeSplitTables16(c, ctx));
+        regions = regions && dst == expected;
+    }
+    cout << regions;
+
+    const int k = 20, m = 4;
+    const size_t count = 77;
+    WideCode code = makeWideCode(k, m, ctx);
+    vector<vector<uint16_t>> storage(k + m, vector<uint16_t>(count));
+    vector<uint16_t*> blocks;
+    for (vector<uint16_t>& block : storage) {
+        blocks.push_back(block.data());
+    }
+    for (int b = 0; b < k; b++) {
+        for (uint16_t& symbol : storage[b]) {
+            symbol = rng();
+        }
+    }
+    encode(code, blocks, count);
+    vector<vector<uint16_t>> original = storage;
+    bool decodes = true;
+    for (int trial = 0; trial < 50; trial++) {
+        vector<bool> erased(k + m);
+        for (int lost = rng() % (m + 1); lost > 0; lost--) {
+            int b = rng() % (k + m);
+            erased[b] = true;
+            fill(storage[b].begin(), storage[b].end(), 0);
+        }
+        decodes = decodes && decode(code, blocks, erased, count) &&
+                  storage == original;
+        storage = original;
+    }
+    vector<bool> tooMany(k + m);
+    fill(tooMany.begin(), tooMany.begin() + m + 1, true);
+    cout << (decodes && !decode(code, blocks, tooMany, count) &&
+             !decode(code, blocks, vector<bool>(k), count));
+
+    // The FFT agrees with Horner's rule on a shifted subspace and inverts
+    const int logSize = 6;
+    vector<uint64_t> coeffs(1 << logSize);
+    for (uint64_t& c : coeffs) {
+        c = rng() & ctx.mask;
+    }
+    uint64_t shift = 0x1240;
+    AdditiveFft plan =
+        makeAdditiveFft(logSize, shift, standardBasis(logSize), ctx);
+    vector<uint64_t> values = coeffs;
+    additiveFft(plan, values);
+    bool fft = true;
+    for (size_t j = 0; j < values.size(); j++) {
+        fft = fft && values[j] == hornerEval(coeffs, shift ^ j, ctx);
+    }
+    additiveIfft(plan, values);
+    cout << (fft && values == coeffs);
+
+    // Evaluation codes: any n - k erasures are filled in
+    LogTables tables = makeLogTables(ctx);
+    const size_t n = 300;
+    const int dimension = 200;
+    vector<uint64_t> data(dimension);
+    for (uint64_t& symbol : data) {
+        symbol = rng() & ctx.mask;
+    }
+    vector<uint64_t> codeword = encodeEvaluation(data, n, ctx, tables);
+    bool evaluation = equal(data.begin(), data.end(), codeword.begin());
+    for (int trial = 0; trial < 5; trial++) {
+        vector<uint64_t> received = codeword;
+        vector<bool> erased(n);
+        for (size_t lost = 0; lost < n - dimension;) {
+            size_t i = rng() % n;
+            if (!erased[i]) {
+                erased[i] = true;
+                received[i] = rng() & ctx.mask;
+                lost++;
+            }
+        }
+        evaluation = evaluation &&
+                     decodeErasures(received, erased, dimension, ctx,
+                                    tables) &&
+                     received == codeword;
+        erased[find(erased.begin(), erased.end(), false) - erased.begin()] =
+            true;
+        evaluation = evaluation &&
+                     !decodeErasures(received, erased, dimension, ctx, tables);
+    }
+    cout << evaluation;
+
+    // Parameters needing more points than the field has are refused
+    vector<uint64_t> tooLong(ctx.mask + 2);
+    WideCode tooWide = makeWideCode(65000, 537, ctx);
+    cout << (tooWide.matrix.empty() && !encode(tooWide, blocks, count) &&
+             !decode(tooWide, blocks, vector<bool>(k + m), count) &&
+             makeWideCode(k, m, makeFieldContext(Polynomial(0x11D)))
+                 .matrix.empty() &&
+             encodeEvaluation(data, tooLong.size(), ctx, tables).empty() &&
+             !decodeErasures(tooLong, vector<bool>(tooLong.size()), 1, ctx,
+                             tables))
+         << '\n';
+}
+
+void testGoppaCodes() {
+    cout << "Goppa code tests:\n";
+    mt19937_64 rng(97);
+    FieldContext ctx = makeFieldContext(Polynomial(0x1009), true);
+
+    // A product of two quadratics is reducible, and an irreducible g has
+    // no roots in the field
+    vector<uint64_t> a = {rng() & ctx.mask, rng() & ctx.mask, 1};
+    vector<uint64_t> b = {rng() & ctx.mask, rng() & ctx.mask, 1};
+    vector<uint64_t> product(5);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            product[i + j] ^= mulMod(a[i], b[j], ctx);
+        }
+    }
+    const int t = 8, n = 256;
+    GoppaKey key = generateGoppaKey(t, n, ctx);
+    vector<uint64_t> elements(ctx.mask + 1);
+    iota(elements.begin(), elements.end(), 0);
+    vector<uint64_t> values = hornerEval(key.goppa, elements, ctx);
+    cout << (!isIrreducibleOver(product, ctx) &&
+             isIrreducibleOver(key.goppa, ctx) &&
+             count(values.begin(), values.end(), 0) == 0);
+
+    // Every error of weight up to t is found from its syndrome
+    bool decodes = key.publicKey.size() == (size_t)ctx.deg * t * 3;
+    for (int trial = 0; trial < 40; trial++) {
+        vector<uint64_t> error(n / WORD_BITS);
+        for (int weight = 0; weight < trial % (t + 1);) {
+            int j = rng() % n;
+            weight += !((error[j / WORD_BITS] >> (j % WORD_BITS)) & 1);
+            error[j / WORD_BITS] |= 1ULL << (j % WORD_BITS);
+        }
+        decodes = decodes &&
+                  decodeGoppa(key, goppaSyndrome(key, error)) == error;
+    }
+    cout << decodes << '\n';
+}
+
+#ifdef __linux__
+void testFilePipeline() {
+    cout << "File pipeline tests:\n";
+    mt19937_64 rng(96);
+    FieldContext ctx = makeFieldContext(Polynomial(0x11D));
+    const int k = 6, groups = 2, globals = 2, n = k + groups + globals;
+    const size_t blockSize = 4096;
+    LocalCode code = makeLocalCode(k, groups, globals, ctx);
+    auto encodeStripe = [&](const vector<uint8_t*>& blocks, size_t size) {
+        encode(code, blocks, size);
+    };
+    auto decodeStripe = [&](const vector<uint8_t*>& blocks,
+                            const vector<bool>& erased, size_t size) {
+        return decode(code, blocks, erased, size);
+    };
+
+    // In the temp directory; with O_DIRECT unsupported there the direct
+    // runs fall back to buffered I/O.
+    filesystem::path directory = filesystem::temp_directory_path();
+    string input = (directory / "pipeline_test.input").string();
+    string output = (directory / "pipeline_test.output").string();
+    vector<string> files;
+    for (int i = 0; i < n; i++) {
+        files.push_back(
+            (directory / ("pipeline_test." + to_string(i))).string());
+    }
+    string contents(5 * k * blockSize + 1234, 0);
+    for (char& c : contents) {
+        c = rng();
+    }
+    ofstream(input, ios::binary) << contents;
+    auto read = [](const string& path) {
+        ifstream file(path, ios::binary);
+        return string(istreambuf_iterator<char>(file), {});
+    };
+
+    // Every combination of ring and O_DIRECT writes the same blocks, and
+    // the file comes back from any globals + 1 of them erased
+    vector<string> expected;
+    bool encodes = true, decodes = true;
+    for (bool useRing : {false, true}) {
+        for (bool direct : {false, true}) {
+            encodes = encodes && encodeFile(input, files, k, blockSize,
+                                            encodeStripe, direct, useRing);
+            vector<string> blocks;
+            for (const string& file : files) {
+                blocks.push_back(read(file));
+            }
+            if (expected.empty()) {
+                expected = blocks;
+            }
+            encodes = encodes && blocks == expected &&
+                      blocks[0].size() == 6 * blockSize;
+
+            vector<bool> erased(n);
+            for (int lost = 0; lost <= globals;) {
+                int b = rng() % n;
+                lost += !erased[b];
+                erased[b] = true;
+            }
+            decodes = decodes &&
+                      decodeFile(files, erased, k, blockSize,
+                                 contents.size(), output, decodeStripe,
+                                 direct, useRing) &&
+                      read(output) == contents;
+        }
+    }
+    cout << encodes << decodes;
+
+    // A missing block file fails cleanly
+    filesystem::remove(files[0]);
+    cout << !decodeFile(files, vector<bool>(n), k, blockSize,
+                        contents.size(), output, decodeStripe)
+         << '\n';
+    for (const string& file : files) {
+        filesystem::remove(file);
+    }
+    filesystem::remove(input);
+    filesystem::remove(output);
+}
+#endif
+
+void testSubproductTrees() {
+    cout << "Subproduct tree tests:\n";
+    mt19937_64 rng(98);
+    FieldContext ctx = makeFieldContext(Polynomial(0x1100B));
+    auto randomPoly = [&](size_t size) {
+        vector<uint64_t> res(size);
+        for (uint64_t& c : res) {
+            c = rng() & ctx.mask;
+        }
+        return res;
+    };
+
+    // Karatsuba, slices of unequal operands and the FFT all agree with
+    // schoolbook
+    bool multiplies = true;
+    for (pair<size_t, size_t> sizes :
+         vector<pair<size_t, size_t>>{{1, 9}, {30, 30}, {100, 37},
+                                      {257, 300}, {2100, 2100}}) {
+        vector<uint64_t> a = randomPoly(sizes.first);
+        vector<uint64_t> b = randomPoly(sizes.second);
+        vector<uint64_t> expected(a.size() + b.size() - 1);
+        mulSchoolbook(a.data(), a.size(), b.data(), b.size(),
+                      expected.data(), ctx);
+        multiplies = multiplies && mulFieldPoly(a, b, ctx) == expected &&
+                     mulFft(a, b, ctx) == expected;
+    }
+    vector<uint64_t> f = randomPoly(50);
+    vector<uint64_t> product = mulFieldPoly(f, inverseSeries(f, 77, ctx), ctx);
+    product.resize(77);
+    vector<uint64_t> one(77);
+    one[0] = 1;
+    cout << multiplies << (product == one);
+
+    // Evaluation matches Horner's rule, also for degrees past the number
+    // of points, and interpolation gives the polynomial back
+    vector<uint64_t> points(ctx.mask + 1);
+    iota(points.begin(), points.end(), 0);
+    shuffle(points.begin(), points.end(), rng);
+    points.resize(300);
+    SubproductTree tree = makeSubproductTree(points, ctx);
+    bool evaluates = true;
+    for (size_t size : {1, 5, 300, 700}) {
+        vector<uint64_t> g = randomPoly(size);
+        evaluates = evaluates &&
+                    multipointEval(tree, g) == hornerEval(g, points, ctx);
+    }
+    vector<uint64_t> g = randomPoly(300);
+    cout << evaluates << (interpolate(tree, multipointEval(tree, g)) == g);
+
+    // A value missing, or a repeated point, leaves no interpolant
+    vector<uint64_t> values = multipointEval(tree, g);
+    values.pop_back();
+    points[1] = points[0];
+    SubproductTree repeated = makeSubproductTree(points, ctx);
+    cout << (interpolate(tree, values).empty() &&
+             interpolate(repeated, multipointEval(repeated, g)).empty())
+         << '\n';
+}
+
+void testFftMultiplication() {
+    cout << "GF(2)[x] FFT multiplication tests:\n";
+    mt19937_64 rng(99);
+    auto randomPoly = [&](size_t words) {
+        BigPolynomial res;
+        res.words.resize(words);
+        for (uint64_t& word : res.words) {
+            word = rng();
+        }
+        trim(res);
+        return res;
+    };
+
+    bool multiplies = true;
+    for (pair<size_t, size_t> sizes :
+         vector<pair<size_t, size_t>>{{1, 1}, {3, 50}, {300, 1000}}) {
+        BigPolynomial a = randomPoly(sizes.first);
+        BigPolynomial b = randomPoly(sizes.second);
+        BigPolynomial product;
+        mulFft(a, b, product);
+        multiplies = multiplies && product == a * b;
+    }
+    // operator* switches to the FFT at the threshold, also when the
+    // product replaces an operand
+    BigPolynomial a = randomPoly(GF2_FFT_THRESHOLD);
+    BigPolynomial b = randomPoly(GF2_FFT_THRESHOLD);
+    a.words.back() |= 1;
+    b.words.back() |= 1;
+    BigPolynomial expected;
+    expected.words.assign(2 * GF2_FFT_THRESHOLD, 0);
+    mulKaratsuba(a.words.data(), b.words.data(), GF2_FFT_THRESHOLD,
+                 expected.words.data());
+    trim(expected);
+    multiplies = multiplies && a * b == expected;
+    mulInto(a, b, a);
+    cout << (multiplies && a == expected);
+
+    // Barrett reduction agrees with the table-driven one, also for
+    // operands past twice the degree of the modulus
+    BigPolynomial p = randomPoly(40) + fromExponents({40 * WORD_BITS + 7});
+    BarrettModulus barrett = makeBarrettModulus(p);
+    bool reduces = true;
+    for (size_t words : {1, 30, 80, 200, 500}) {
+        BigPolynomial a = randomPoly(words);
+        reduces = reduces && a % barrett == a % p;
+    }
+    cout << reduces;
+
+    BigPolynomial dense = fromExponents({521, 32, 0});
+    cout << (frobeniusPower(1000, makeBarrettModulus(p)) ==
+                 frobeniusPower(1000, p) &&
+             isIrreducible(makeBarrettModulus(dense)) &&
+             !isIrreducible(makeBarrettModulus(dense + fromExponents({1}))))
+         << '\n';
+}
+
+void testParallelMultiplication() {
+    cout << "Parallel multiplication tests:\n";
+    mt19937_64 rng(100);
+
+    // Karatsuba over GF(2) with parallel levels against the schoolbook
+    // product, repeated to catch results that depend on the scheduling
+    BigPolynomial a, b;
+    for (int i = 0; i < 1500; i++) {
+        a.words.push_back(rng());
+        b.words.push_back(rng());
+    }
+    BigPolynomial expected;
+    expected.words.assign(3000, 0);
+    mulSchoolbook(a.words.data(), 1500, b.words.data(), 1500,
+                  expected.words.data());
+    trim(expected);
+    bool repeatable = true;
+    for (int i = 0; i < 3; i++) {
+        repeatable = repeatable && a * b == expected;
+    }
+    cout << repeatable;
+
+    // Over GF(2^16) the parallel Karatsuba and the parallel FFT agree
+    FieldContext ctx = makeFieldContext(Polynomial(0x1100B));
+    vector<uint64_t> x(8192), y(8192);
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = rng() & ctx.mask;
+        y[i] = rng() & ctx.mask;
+    }
+    vector<uint64_t> karatsuba(2 * x.size() - 1);
+    mulKaratsuba(x.data(), y.data(), x.size(), karatsuba.data(), ctx);
+    cout << (mulFft(x, y, ctx) == karatsuba);
+
+    // Transforms large enough to split match smaller pieces done serially
+    AdditiveFft plan = makeAdditiveFft(15, 0, standardBasis(15), ctx);
+    vector<uint64_t> values(x);
+    values.resize(1 << 15);
+    vector<uint64_t> original(values);
+    additiveFft(plan, values);
+    bool evaluates = true;
+    for (size_t j : {0, 1, 12345, 32767}) {
+        evaluates = evaluates && values[j] == hornerEval(original, j, ctx);
+    }
+    additiveIfft(plan, values);
+    cout << (evaluates && values == original) << '\n';
+}
+
+void runTests() {
+    testAddition();
+    testMultiplication();
+    testRemainder();
+    testFindFieldElements();
+    testApplication();
+    testCanonicalCandidates();
+    testBigPolynomials();
+    testTrinomialSearch();
+    testJumpPolynomials();
+    testSparsePolynomials();
+    testSmallPolynomials();
+    testFieldContext();
+    testBitslicing();
+    testTransposes();
+    testBranchFree();
+    testThreadPool();
+    testArena();
+    testLazyExpressions();
+    testLazyReduction();
+    testFixedMultiplier();
+    testChienSearch();
+    testSecretSharing();
+    testCauchyCoding();
+    testLocalCodes();
+    testReedSolomon16();
+#ifdef __linux__
+    testFilePipeline();
+#endif
+    testGoppaCodes();
+    testSubproductTrees();
+    testFftMultiplication();
+    testParallelMultiplication();
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start)
+        .count();
+}
+
+void benchmarkTransposes() {
+    cout << "Transposes (ns per matrix):\n";
+    mt19937_64 rng(84);
+    const int count = 1 << 16;
+    vector<uint64_t> small(count), smallT(count);
+    for (uint64_t& m : small) {
+        m = rng();
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        Polynomial rows(small[i]), columns;
+        for (int j = 0; j < 64; j++) {
+            columns[8 * (j % 8) + j / 8] = rows[j];
+        }
+        smallT[i] = columns.to_ullong();
+    }
+    cout << "8x8 bit by bit:  " << secondsSince(start) * 1e9 / count << '\n';
+
+    const int repeats = 100;
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        transpose8x8(small.data(), smallT.data(), count);
+    }
+    cout << "8x8 kernel:      "
+         << secondsSince(start) * 1e9 / count / repeats << '\n';
+
+    const int blocks = count / 64;
+    start = chrono::steady_clock::now();
+    for (int b = 0; b < blocks; b++) {
+        Polynomial columns[64];
+        for (int i = 0; i < 64; i++) {
+            Polynomial row(small[64 * b + i]);
+            for (int j = 0; j < 64; j++) {
+                columns[j][i] = row[j];
+            }
+        }
+        for (int j = 0; j < 64; j++) {
+            smallT[64 * b + j] = columns[j].to_ullong();
+        }
+    }
+    cout << "64x64 bit by bit: " << secondsSince(start) * 1e9 / blocks << '\n';
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        for (int b = 0; b < blocks; b++) {
+            transpose64x64(small.data() + 64 * b);
+        }
+    }
+    cout << "64x64 kernel:     "
+         << secondsSince(start) * 1e9 / blocks / repeats << '\n';
+}
+
+void benchmarkBranchFree() {
+    cout << "Branching vs branch-free on random data (ns per operation):\n";
+    mt19937_64 rng(85);
+    const int count = 1 << 16;
+    vector<Polynomial> a(count), b(count);
+    for (int i = 0; i < count; i++) {
+        a[i] = Polynomial(rng() >> 32);
+        b[i] = Polynomial((rng() >> 32) | (1ULL << 31));
+    }
+
+    Polynomial sink;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        sink ^= a[i] * b[i] % b[(i + 1) % count];
+    }
+    cout << "operator* and operator%:       "
+         << secondsSince(start) * 1e9 / count << '\n';
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        sink ^= remBranchFree(mulBranchFree(a[i], b[i]), b[(i + 1) % count]);
+    }
+    cout << "mulBranchFree and remBranchFree: "
+         << secondsSince(start) * 1e9 / count << '\n';
+
+    FieldContext fast = makeFieldContext(Polynomial(0x1000000AF));
+    FieldContext constantTime = makeFieldContext(Polynomial(0x1000000AF), true);
+    uint64_t inverses = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        inverses ^= inverse(b[i].to_ullong(), fast);
+    }
+    cout << "inverse (Euclid):              "
+         << secondsSince(start) * 1e9 / count << '\n';
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        inverses ^= inverse(b[i].to_ullong(), constantTime);
+    }
+    cout << "inverse (constant time):       "
+         << secondsSince(start) * 1e9 / count << '\n';
+    cout << (sink.count() + inverses == 0 ? "" : "\n");
+}
+
+void benchmarkArena() {
+    cout << "Modular multiplication of multi-word polynomials (ns):\n";
+    mt19937_64 rng(87);
+    for (int words : {4, 16, 40, 128}) {
+        BigPolynomial a, b, p;
+        for (int i = 0; i < words; i++) {
+            a.words.push_back(rng());
+            b.words.push_back(rng());
+            p.words.push_back(rng());
+        }
+        p.words.push_back(1);
+        int repeats = 2000000 / (words * words) + 100;
+
+        BigPolynomial res;
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++) {
+            res = mulMod(a, b, p);
+        }
+        double returned = secondsSince(start) * 1e9 / repeats;
+
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++) {
+            mulInto(a, b, res);
+            reduceInPlace(res, p);
+        }
+        double inPlace = secondsSince(start) * 1e9 / repeats;
+        cout << words << " words: mulMod " << returned
+             << ", mulInto and reduceInPlace " << inPlace << '\n';
+    }
+}
+
+void benchmarkLazyReduction() {
+    cout << "Reducing once vs every product, GF(2^32) (ns per product):\n";
+    mt19937_64 rng(89);
+    FieldContext ctx = makeFieldContext(Polynomial(0x100400007));
+    const int count = 4096;
+    const int repeats = 100;
+    vector<uint64_t> a(count), b(count), points(32);
+    for (int i = 0; i < count; i++) {
+        a[i] = rng() & ctx.mask;
+        b[i] = rng() & ctx.mask;
+    }
+    for (uint64_t& x : points) {
+        x = rng() & ctx.mask;
+    }
+
+    uint64_t sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        for (int i = 0; i < count; i++) {
+            sink ^= mulMod(a[i], b[i] ^ r, ctx);
+        }
+    }
+    cout << "mulMod and XOR:        "
+         << secondsSince(start) * 1e9 / count / repeats << '\n';
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        b[0] ^= r;
+        sink ^= dot(a, b, ctx);
+    }
+    cout << "dot:                   "
+         << secondsSince(start) * 1e9 / count / repeats << '\n';
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        uint64_t value = 0;
+        for (int i = count; i-- > 0;) {
+            value = mulMod(value, points[r % 32], ctx) ^ a[i];
+        }
+        sink ^= value;
+    }
+    cout << "Horner, one chain:     "
+         << secondsSince(start) * 1e9 / count / repeats << '\n';
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        sink ^= hornerEval(a, points[r % 32], ctx);
+    }
+    cout << "hornerEval, one point: "
+         << secondsSince(start) * 1e9 / count / repeats << '\n';
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats / 10; r++) {
+        sink ^= hornerEval(a, points, ctx)[r % 32];
+    }
+    cout << "hornerEval, 32 points: "
+         << secondsSince(start) * 1e9 / count / (repeats / 10) / 32 << '\n';
+    cout << (sink == 0 ? "\n" : "");
+}
+
+void benchmarkFixedMultiplier() {
+    cout << "Multiplication by a fixed element of GF(2^32) (ns):\n";
+    mt19937_64 rng(90);
+    FieldContext ctx = makeFieldContext(Polynomial(0x100400007));
+    FieldContext constantTime = makeFieldContext(Polynomial(0x100400007), true);
+    const int count = 1 << 16;
+    vector<uint64_t> a(count);
+    for (uint64_t& x : a) {
+        x = rng() & ctx.mask;
+    }
+    uint64_t b = rng() & ctx.mask;
+
+    uint64_t sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        sink ^= mulMod(a[i], b, ctx);
+    }
+    cout << "mulMod:                 " << secondsSince(start) * 1e9 / count
+         << '\n';
+
+    for (int window : {4, 8}) {
+        start = chrono::steady_clock::now();
+        FixedMultiplier m = makeFixedMultiplier(b, ctx, window);
+        double setup = secondsSince(start) * 1e9;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            sink ^= multiply(m, a[i]);
+        }
+        cout << window << "-bit windows:         "
+             << secondsSince(start) * 1e9 / count << " (tables " << setup
+             << ")\n";
+    }
+
+    FixedMultiplier m = makeFixedMultiplier(b, constantTime);
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        sink ^= multiply(m, a[i]);
+    }
+    cout << "4-bit, constant time:   " << secondsSince(start) * 1e9 / count
+         << '\n';
+    cout << (sink == 0 ? "\n" : "");
+}
+
+void benchmarkChienSearch() {
+    cout << "Chien search for 16 errors (us per search):\n";
+    mt19937_64 rng(91);
+    for (const Polynomial& p : {Polynomial(0x11D), Polynomial(0x1100B)}) {
+        FieldContext ctx = makeFieldContext(p);
+        vector<uint64_t> locator(17);
+        for (uint64_t& c : locator) {
+            c = rng() & ctx.mask;
+        }
+        int repeats = ctx.deg == 8 ? 1000 : 10;
+
+        // Term by term, one position at a time
+        uint64_t sink = 0;
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++) {
+            vector<uint64_t> terms = locator, alphaJ(locator.size());
+            for (size_t j = 0; j < locator.size(); j++) {
+                alphaJ[j] = power(2, j, ctx);
+            }
+            for (uint64_t i = 0; i < ctx.mask; i++) {
+                uint64_t sum = 0;
+                for (size_t j = 0; j < terms.size(); j++) {
+                    sum ^= terms[j];
+                    terms[j] = mulMod(terms[j], alphaJ[j], ctx);
+                }
+                sink += sum == 0;
+            }
+        }
+        cout << "GF(2^" << ctx.deg << "), scalar:     "
+             << secondsSince(start) * 1e6 / repeats << '\n';
+
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++) {
+            sink += chienSearch(locator, ctx).size();
+        }
+        cout << "GF(2^" << ctx.deg << "), bitsliced:  "
+             << secondsSince(start) * 1e6 / repeats << '\n';
+        cout << (sink == 1 ? "\n" : "");
+    }
+}
+
+void benchmarkSecretSharing() {
+    cout << "Secret sharing of 16 MB, 5 shares, threshold 3 (MB/s):\n";
+    mt19937_64 rng(92);
+    FieldContext ctx = makeFieldContext(Polynomial(0x11D));
+    vector<uint8_t> secret(1 << 24);
+    for (uint8_t& b : secret) {
+        b = rng();
+    }
+    double megabytes = secret.size() / 1e6;
+
+    // Byte by byte, as field elements, on the first MB
+    const size_t part = 1 << 20;
+    vector<uint8_t> coefficients(2 * part);
+    for (uint8_t& b : coefficients) {
+        b = rng();
+    }
+    vector<vector<uint8_t>> scalarShares(5, vector<uint8_t>(part));
+    auto start = chrono::steady_clock::now();
+    for (int s = 0; s < 5; s++) {
+        for (size_t i = 0; i < part; i++) {
+            uint64_t value = coefficients[2 * i + 1];
+            value = mulMod(value, s + 1, ctx) ^ coefficients[2 * i];
+            scalarShares[s][i] = mulMod(value, s + 1, ctx) ^ secret[i];
+        }
+    }
+    cout << "split, scalar:  " << part / 1e6 / secondsSince(start) << '\n';
+
+    start = chrono::steady_clock::now();
+    vector<Share> shares = splitSecret(secret, 5, 3, ctx);
+    cout << "split, regions: " << megabytes / secondsSince(start) << '\n';
+
+    shares.resize(3);
+    start = chrono::steady_clock::now();
+    bool correct = combineShares(shares, ctx) == secret;
+    cout << "combine:        " << megabytes / secondsSince(start) << '\n';
+
+    NibbleTables tables = makeNibbleTables(0x53, ctx);
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < 10; r++) {
+        mulAddRegion(secret.data(), shares[0].data.data(), secret.size(),
+                     tables);
+    }
+    cout << "mulAddRegion:   " << 10 * megabytes / secondsSince(start) << '\n';
+    cout << (correct ? "" : "combine failed\n");
+}
+
+void benchmarkCauchyCoding() {
+    cout << "Encoding 10 data blocks of 1 MB into 4 coding blocks (MB/s):\n";
+    mt19937_64 rng(93);
+    FieldContext ctx = makeFieldContext(Polynomial(0x11D));
+    const int k = 10, m = 4;
+    const size_t blockSize = 1 << 20;
+    vector<vector<uint8_t>> storage(k + m, vector<uint8_t>(blockSize));
+    vector<uint8_t*> blocks;
+    for (vector<uint8_t>& block : storage) {
+        blocks.push_back(block.data());
+    }
+    for (int b = 0; b < k; b++) {
+        for (uint8_t& byte : storage[b]) {
+            byte = rng();
+        }
+    }
+    vector<uint8_t*> data(blocks.begin(), blocks.begin() + k);
+    vector<uint8_t*> coding(blocks.begin() + k, blocks.end());
+    double megabytes = k * blockSize / 1e6;
+
+    // Plain Cauchy matrix: bit matrix ones vs XORs after scaling and CSE
+    vector<uint64_t> plain(m * k);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < k; j++) {
+            plain[i * k + j] = inverse((uint64_t)i ^ (m + j), ctx);
+        }
+    }
+    vector<uint8_t> plainBits = toBitmatrix(plain, m, k, ctx);
+    CauchyCode code = makeCauchyCode(k, m, ctx);
+    vector<uint8_t> bits = toBitmatrix(code.matrix, m, k, ctx);
+    int xors = 0;
+    for (const XorStep& step : code.encoder.steps) {
+        xors += !step.assign;
+    }
+    cout << "XORs: plain " << count(plainBits.begin(), plainBits.end(), 1) -
+                                  m * 8
+         << ", scaled " << count(bits.begin(), bits.end(), 1) - m * 8
+         << ", with CSE " << xors << '\n';
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < m; i++) {
+        fill(coding[i], coding[i] + blockSize, 0);
+        for (int j = 0; j < k; j++) {
+            mulAddRegion(coding[i], data[j], blockSize,
+                         makeNibbleTables(code.matrix[i * k + j], ctx));
+        }
+    }
+    cout << "mulAddRegion:   " << megabytes / secondsSince(start) << '\n';
+
+    start = chrono::steady_clock::now();
+    encode(code, data, coding, blockSize);
+    cout << "XOR schedule:   " << megabytes / secondsSince(start) << '\n';
+}
+
+void benchmarkLocalCodes() {
+    cout << "Repairing one data block of 1 MB, 12 data blocks in 2 groups "
+            "(ms):\n";
+    mt19937_64 rng(94);
+    FieldContext ctx = makeFieldContext(Polynomial(0x11D));
+    const int k = 12, groups = 2, globals = 2, n = k + groups + globals;
+    const size_t blockSize = 1 << 20;
+    LocalCode code = makeLocalCode(k, groups, globals, ctx);
+    vector<vector<uint8_t>> storage(n, vector<uint8_t>(blockSize));
+    vector<uint8_t*> blocks;
+    for (vector<uint8_t>& block : storage) {
+        blocks.push_back(block.data());
+    }
+    for (int b = 0; b < k; b++) {
+        for (uint8_t& byte : storage[b]) {
+            byte = rng();
+        }
+    }
+    encode(code, blocks, blockSize);
+
+    auto start = chrono::steady_clock::now();
+    repairLocal(code, blocks, 3, blockSize);
+    cout << "local, reading " << groupSize(code) << " blocks:  "
+         << secondsSince(start) * 1e3 << '\n';
+
+    // The same loss with the local parity gone too, so that the global
+    // parities are needed
+    vector<bool> erased(n);
+    erased[3] = erased[k] = true;
+    start = chrono::steady_clock::now();
+    decode(code, blocks, erased, blockSize);
+    cout << "global, reading " << k << " blocks: "
+         << secondsSince(start) * 1e3 << '\n';
+}
+
+void benchmarkReedSolomon16() {
+    cout << "GF(2^16) Reed-Solomon (MB/s):\n";
+    mt19937_64 rng(95);
+    FieldContext ctx = makeFieldContext(Polynomial(0x1100B));
+    const size_t count = 1 << 19;
+    vector<uint16_t> src(count), dst(count);
+    for (uint16_t& symbol : src) {
+        symbol = rng();
+    }
+    SplitTables16 tables16 = makeSplitTables16(0x1234, ctx);
+    auto start = chrono::steady_clock::now();
+    for (int rep = 0; rep < 16; rep++) {
+        mulAddRegion16(dst.data(), src.data(), count, tables16);
+    }
+    cout << "region multiply-add: "
+         << 16 * 2.0 * count / secondsSince(start) / 1e6 << '\n';
+
+    const int k = 64, m = 8;
+    const size_t blockSymbols = 1 << 15;
+    WideCode code = makeWideCode(k, m, ctx);
+    vector<vector<uint16_t>> storage(k + m, vector<uint16_t>(blockSymbols));
+    vector<uint16_t*> blocks;
+    for (vector<uint16_t>& block : storage) {
+        blocks.push_back(block.data());
+    }
+    for (int b = 0; b < k; b++) {
+        for (uint16_t& symbol : storage[b]) {
+            symbol = rng();
+        }
+    }
+    start = chrono::steady_clock::now();
+    encode(code, blocks, blockSymbols);
+    double megabytes = k * 2.0 * blockSymbols / 1e6;
+    cout << "encode, 64 + 8:      " << megabytes / secondsSince(start)
+         << '\n';
+    vector<bool> erased(k + m);
+    for (int b = 0; b < m; b++) {
+        erased[3 * b] = true;
+    }
+    start = chrono::steady_clock::now();
+    decode(code, blocks, erased, blockSymbols);
+    cout << "decode, 8 lost:      " << megabytes / secondsSince(start)
+         << '\n';
+
+    // One long codeword, decoded with the FFT
+    LogTables tables = makeLogTables(ctx);
+    const size_t n = 1 << 14;
+    vector<uint64_t> data(n * 3 / 4);
+    for (uint64_t& symbol : data) {
+        symbol = rng() & ctx.mask;
+    }
+    start = chrono::steady_clock::now();
+    vector<uint64_t> codeword = encodeEvaluation(data, n, ctx, tables);
+    cout << "FFT encode, n = " << n << ": "
+         << data.size() * 2.0 / secondsSince(start) / 1e6 << '\n';
+}
+
+void benchmarkGoppaCodes() {
+    cout << "Goppa codes, m = 12, t = 64, n = 3488 (ms):\n";
+    mt19937_64 rng(97);
+    FieldContext ctx = makeFieldContext(Polynomial(0x1009), true);
+    const int t = 64, n = 3488;
+    // Averaged, as the number of supports drawn varies
+    const int keys = 5;
+    GoppaKey key;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < keys; i++) {
+        key = generateGoppaKey(t, n, ctx);
+    }
+    cout << "key generation: " << secondsSince(start) * 1e3 / keys << '\n';
+
+    vector<uint64_t> error((n + WORD_BITS - 1) / WORD_BITS);
+    for (int weight = 0; weight < t;) {
+        int j = rng() % n;
+        weight += !((error[j / WORD_BITS] >> (j % WORD_BITS)) & 1);
+        error[j / WORD_BITS] |= 1ULL << (j % WORD_BITS);
+    }
+    vector<uint64_t> syndrome = goppaSyndrome(key, error);
+    start = chrono::steady_clock::now();
+    bool decoded = decodeGoppa(key, syndrome) == error;
+    cout << "decoding:       " << secondsSince(start) * 1e3
+         << (decoded ? "" : " (failed)") << '\n';
+}
+
+#ifdef __linux__
+void benchmarkFilePipeline() {
+    cout << "Encoding a 256 MB file, 10 + 4 Cauchy code, 1 MB blocks "
+            "(MB/s):\n";
+    FieldContext ctx = makeFieldContext(Polynomial(0x11D));
+    const int k = 10, m = 4;
+    const size_t blockSize = 1 << 20, size = 256 << 20;
+    CauchyCode code = makeCauchyCode(k, m, ctx);
+    auto encodeStripe = [&](const vector<uint8_t*>& blocks, size_t bytes) {
+        encode(code, vector<uint8_t*>(blocks.begin(), blocks.begin() + k),
+               vector<uint8_t*>(blocks.begin() + k, blocks.end()), bytes);
+    };
+
+    string input = "pipeline_benchmark.input";
+    vector<string> files;
+    for (int i = 0; i < k + m; i++) {
+        files.push_back("pipeline_benchmark." + to_string(i));
+    }
+    {
+        mt19937_64 rng(96);
+        vector<uint64_t> chunk(1 << 17);
+        ofstream file(input, ios::binary);
+        for (size_t done = 0; done < size; done += 8 * chunk.size()) {
+            for (uint64_t& word : chunk) {
+                word = rng();
+            }
+            file.write((const char*)chunk.data(), 8 * chunk.size());
+        }
+    }
+
+    for (bool useRing : {false, true}) {
+        for (bool direct : {false, true}) {
+            auto start = chrono::steady_clock::now();
+            encodeFile(input, files, k, blockSize, encodeStripe, direct,
+                       useRing);
+            cout << (useRing ? "io_uring" : "pread/pwrite")
+                 << (direct ? ", O_DIRECT" : "") << ": "
+                 << size / secondsSince(start) / 1e6 << '\n';
+        }
+    }
+    for (const string& file : files) {
+        remove(file.c_str());
+    }
+    remove(input.c_str());
+}
+#endif
+
+void benchmarkSubproductTrees() {
+    cout << "Evaluating and interpolating a polynomial of degree n - 1 at n "
+            "points of GF(2^16) (ms):\n";
+    mt19937_64 rng(98);
+    FieldContext ctx = makeFieldContext(Polynomial(0x1100B));
+    for (size_t n : {1024, 8192, 32768}) {
+        vector<uint64_t> points(ctx.mask + 1);
+        iota(points.begin(), points.end(), 0);
+        shuffle(points.begin(), points.end(), rng);
+        points.resize(n);
+        vector<uint64_t> f(n);
+        for (uint64_t& c : f) {
+            c = rng() & ctx.mask;
+        }
+
+        auto start = chrono::steady_clock::now();
+        vector<uint64_t> expected = hornerEval(f, points, ctx);
+        double horner = secondsSince(start);
+        start = chrono::steady_clock::now();
+        SubproductTree tree = makeSubproductTree(points, ctx);
+        double build = secondsSince(start);
+        start = chrono::steady_clock::now();
+        vector<uint64_t> values = multipointEval(tree, f);
+        double evaluation = secondsSince(start);
+        start = chrono::steady_clock::now();
+        bool same = interpolate(tree, values) == f && values == expected;
+        double interpolation = secondsSince(start);
+        cout << "n = " << n << ": Horner " << horner * 1e3 << ", tree "
+             << build * 1e3 << ", evaluation " << evaluation * 1e3
+             << ", interpolation " << interpolation * 1e3
+             << (same ? "" : " (wrong)") << '\n';
+    }
+}
+
+void benchmarkFftMultiplication() {
+    cout << "GF(2)[x] multiplication of two polynomials of n bits (ms):\n";
+    mt19937_64 rng(99);
+    auto randomPoly = [&](size_t words) {
+        BigPolynomial res;
+        res.words.resize(words);
+        for (uint64_t& word : res.words) {
+            word = rng();
+        }
+        trim(res);
+        return res;
+    };
+    for (size_t words : {4096, 16384, 65536}) {
+        BigPolynomial a = randomPoly(words), b = randomPoly(words);
+        vector<uint64_t> product(2 * words);
+        auto start = chrono::steady_clock::now();
+        mulKaratsuba(a.words.data(), b.words.data(), words, product.data());
+        double karatsuba = secondsSince(start);
+        BigPolynomial fft;
+        mulFft(a, b, fft);
+        start = chrono::steady_clock::now();
+        mulFft(a, b, fft);
+        cout << "n = " << words * WORD_BITS << ": Karatsuba "
+             << karatsuba * 1e3 << ", FFT " << secondsSince(start) * 1e3
+             << '\n';
+    }
+
+    // One step of x^(2^k) mod p for a dense p of degree 10^6
+    const int degree = 1000000;
+    BigPolynomial p =
+        randomPoly(degree / WORD_BITS) + fromExponents({degree});
+    auto start = chrono::steady_clock::now();
+    BarrettModulus modulus = makeBarrettModulus(p);
+    double setup = secondsSince(start);
+    BigPolynomial a = randomPoly(degree / WORD_BITS);
+    start = chrono::steady_clock::now();
+    BigPolynomial square = squareMod(a, modulus);
+    double squaring = secondsSince(start);
+    start = chrono::steady_clock::now();
+    BigPolynomial product = mulMod(a, square, modulus);
+    cout << "degree 10^6 modulus: Barrett setup " << setup * 1e3
+         << ", squareMod " << squaring * 1e3 << ", mulMod "
+         << secondsSince(start) * 1e3 << '\n';
+}
+
+void runBenchmarks() {
+    benchmarkTransposes();
+    benchmarkBranchFree();
+    benchmarkArena();
+    benchmarkLazyReduction();
+    benchmarkFixedMultiplier();
+    benchmarkChienSearch();
+    benchmarkSecretSharing();
+    benchmarkCauchyCoding();
+    benchmarkLocalCodes();
+    benchmarkReedSolomon16();
+#ifdef __linux__
+    benchmarkFilePipeline();
+#endif
+    benchmarkGoppaCodes();
+    benchmarkSubproductTrees();
+    benchmarkFftMultiplication();
+}
+
+vector<Polynomial> readInput() {
+    cout << "Polynomials are displayed in degree increasing order.\n\n";
+
+    cout << "Enter degree of polynomials you want to use to generate the "
+            "field: ";
+    int deg;
+    cin >> deg;
+
+    cout << "Enter primitive polynomial candidates count: ";
+    int count;
+    cin >> count;
+
+    cout << "Enter polynomials in binary format in increasing degree order "
+            "seperately on new lines:\n";
+    vector<Polynomial> candidates(count);
+    for (int i = 0; i < count; i++) {
+        string polynomial;
+        cin >> polynomial;
+        if (polynomial.size() != deg + 1 || polynomial.back() != '1') {
+            cout << "Invalid polynomial input!\n";
+            return {};
+        }
+        reverse(polynomial.begin(), polynomial.end());
+        candidates[i] = Polynomial(polynomial);
+    }
+
+    return candidates;
+}
+
+int main() {
+    if (RUN_TESTS) {
+        runTests();
+        return 0;
+    }
+
+    if (RUN_BENCHMARKS) {
+        runBenchmarks();
+        return 0;
+    }
+
+    if (TRINOMIAL_SEARCH_DEGREE > 0) {
+        runTrinomialSearch(TRINOMIAL_SEARCH_DEGREE);
         return 0;
     }
 